@@ -0,0 +1,274 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <atomic>
+#include <new>
+#include <cstdlib>
+#include <functional>
+
+#include "Game.h"
+#include "WebSerialization.h"
+#include "json.hpp"
+
+/* Microbenchmarks for the engine hot paths
+	Usage: bench_idle_mech [output.json]
+	Must be run from a directory containing data/ (the build directory after the copy step), unless built with IDLE_MECH_EMBED_ASSETS.
+
+	Every benchmark is run for `samples` rounds of `iterations` calls. Reported per benchmark:
+		- ns/op: mean, stddev, min and max across samples
+		- allocations/op and bytes/op, counted on the benchmark thread only
+	Results are printed as JSON (stdout, or the given file). Engine logging is silenced while measuring.
+*/
+
+#define BENCH_SAMPLES 15
+#define BENCH_MIN_SAMPLE_NS 10000000 // Each sample runs at least 10ms worth of iterations
+#define BENCH_GENERATED_FLOORS 256 // BossGenerator::generate cycles over this many floors past bosses.json
+
+// --- Allocation counting ---
+// Counted per thread so the game loop thread doesn't pollute the numbers
+thread_local unsigned long long tl_alloc_count = 0;
+thread_local unsigned long long tl_alloc_bytes = 0;
+
+// None of the replacements are inlined: GCC would otherwise see the malloc() behind operator new
+// paired with operator delete (or free() with operator new) at the call site and report
+// -Wmismatched-new-delete, although both sides here use malloc/free
+__attribute__((noinline)) void* operator new(std::size_t size) {
+	tl_alloc_count++;
+	tl_alloc_bytes += size;
+	if (void* p = std::malloc(size == 0 ? 1 : size)) {
+		return p;
+	}
+	throw std::bad_alloc();
+}
+
+__attribute__((noinline)) void operator delete(void* p) noexcept {
+	std::free(p);
+}
+
+__attribute__((noinline)) void operator delete(void* p, std::size_t) noexcept {
+	std::free(p);
+}
+
+// Keeps the compiler from optimizing away benchmarked results
+template <typename T>
+inline void doNotOptimize(const T& value) {
+	asm volatile("" : : "r,m"(value) : "memory");
+}
+
+struct BenchResult {
+	std::string name;
+	unsigned long long iterations = 0; // Per sample
+	std::vector<double> ns_per_op;
+	double allocs_per_op = 0;
+	double bytes_per_op = 0;
+};
+
+class NullBuffer : public std::streambuf {
+protected:
+	int overflow(int c) override { return c; }
+};
+
+BenchResult runBenchmark(const std::string& name, const std::function<void()>& fn) {
+	BenchResult result;
+	result.name = name;
+
+	// Calibrate: grow the iteration count until one sample takes long enough to time reliably
+	unsigned long long iterations = 1;
+	while (true) {
+		auto start = std::chrono::steady_clock::now();
+		for (unsigned long long i = 0; i < iterations; i++) fn();
+		auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+		if (elapsed >= BENCH_MIN_SAMPLE_NS || iterations >= (1ULL << 30)) break;
+		iterations *= 2;
+	}
+	result.iterations = iterations;
+
+	unsigned long long alloc_count = 0;
+	unsigned long long alloc_bytes = 0;
+	for (int sample = 0; sample < BENCH_SAMPLES; sample++) {
+		unsigned long long count_before = tl_alloc_count;
+		unsigned long long bytes_before = tl_alloc_bytes;
+		auto start = std::chrono::steady_clock::now();
+		for (unsigned long long i = 0; i < iterations; i++) fn();
+		auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+		alloc_count += tl_alloc_count - count_before;
+		alloc_bytes += tl_alloc_bytes - bytes_before;
+		result.ns_per_op.push_back(static_cast<double>(elapsed) / iterations);
+	}
+
+	double total_ops = static_cast<double>(iterations) * BENCH_SAMPLES;
+	result.allocs_per_op = alloc_count / total_ops;
+	result.bytes_per_op = alloc_bytes / total_ops;
+	return result;
+}
+
+json benchResultToJson(const BenchResult& r) {
+	double sum = 0, min = r.ns_per_op.front(), max = r.ns_per_op.front();
+	for (double v : r.ns_per_op) {
+		sum += v;
+		min = std::min(min, v);
+		max = std::max(max, v);
+	}
+	double mean = sum / r.ns_per_op.size();
+	double sq = 0;
+	for (double v : r.ns_per_op) sq += (v - mean) * (v - mean);
+	double stddev = std::sqrt(sq / r.ns_per_op.size());
+
+	return json{
+		{"name", r.name},
+		{"iterations_per_sample", r.iterations},
+		{"samples", r.ns_per_op.size()},
+		{"ns_per_op", {
+			{"mean", mean},
+			{"stddev", stddev},
+			{"cv", mean > 0 ? stddev / mean : 0.0},
+			{"min", min},
+			{"max", max}
+		}},
+		{"allocs_per_op", r.allocs_per_op},
+		{"bytes_per_op", r.bytes_per_op}
+	};
+}
+
+// Every benchmark that needs a loaded Game. The Game logs when it is destroyed, so it lives only in
+// here and is gone before the report is printed. Throws if the data can't be loaded or a benchmark fails.
+std::vector<BenchResult> runBenchmarks() {
+	Game game;
+	game.loadData("data/items.json", "data/bosses.json", "data/levels.json", "data/loot.json", "data/classes.json");
+
+	// Started the way runReplay starts a recording: on this thread under virtual time, so the game is
+	// running (getGameState reports the real state) but no loop thread ticks while measuring
+	ReplayLog start_log;
+	start_log.seed = game.getSeed();
+	ReplayCommand select_class;
+	select_class.type = ReplayCommandType::SELECT_CLASS;
+	select_class.class_id = "ace";
+	ReplayCommand start;
+	start.type = ReplayCommandType::START_GAME;
+	start_log.commands = {select_class, start};
+	game.runReplay(start_log, 1); // One tick spawns the first enemy
+
+	std::vector<BenchResult> results;
+
+	// Give the player a realistic inventory so the state payload isn't trivially small
+	for (int i = 0; i < 50; i++) {
+		game.player_mech.addToInventory(game.generateRandomItem());
+	}
+
+	results.push_back(runBenchmark("Game::getGameState", [&]() {
+		GameStateForWeb state = game.getGameState();
+		doNotOptimize(state);
+	}));
+
+	GameStateForWeb state = game.getGameState();
+	results.push_back(runBenchmark("to_json(GameStateForWeb)", [&]() {
+		json j = state;
+		std::string body = j.dump();
+		doNotOptimize(body);
+	}));
+
+	results.push_back(runBenchmark("Game::generateRandomItem", [&]() {
+		std::shared_ptr<Item> item = game.generateRandomItem();
+		doNotOptimize(item);
+	}));
+
+	// Loot sampling must not grow with the template count
+	std::vector<double> loot_weights;
+	for (int i = 0; i < 4096; i++) {
+		loot_weights.push_back(1.0 + (i % 7));
+	}
+	AliasTable large_loot_table(loot_weights);
+	results.push_back(runBenchmark("AliasTable::sample (4096 entries)", [&]() {
+		size_t index = large_loot_table.sample(myRandomDouble(0, 1));
+		doNotOptimize(index);
+	}));
+
+	// Floors past bosses.json, cycling over a fixed range: every call interns its boss name for good,
+	// and stats overflow to inf a few thousand floors up
+	int generate_calls = 0;
+	results.push_back(runBenchmark("BossGenerator::generate", [&]() {
+		BossData boss = BossGenerator::generate(game.getSeed(), 4 + (generate_calls++ % BENCH_GENERATED_FLOORS));
+		doNotOptimize(boss);
+	}));
+
+	BossGenerator boss_generator;
+	boss_generator.get(game.getSeed(), 500);
+	results.push_back(runBenchmark("BossGenerator::get (cached floor 500)", [&]() {
+		const BossData& boss = boss_generator.get(game.getSeed(), 500);
+		doNotOptimize(boss.exp_reward);
+	}));
+
+	std::shared_ptr<Item> rolled_item = game.generateRandomItem();
+	results.push_back(runBenchmark("Item::generateInstanceStats", [&]() {
+		rolled_item->generateInstanceStats();
+		doNotOptimize(rolled_item->getStats());
+	}));
+
+	Mech& player = game.player_mech;
+	results.push_back(runBenchmark("Equipment::getTotalStats", [&]() {
+		Stats s = player.getEquipment().getTotalStats();
+		doNotOptimize(s);
+	}));
+
+	results.push_back(runBenchmark("Mech::getTotalStats", [&]() {
+		Stats s = player.getTotalStats();
+		doNotOptimize(s);
+	}));
+
+	Mech target("Bench Target", {
+		{StatType::HEALTH, 1e12},
+		{StatType::ARMOR, 10},
+		{StatType::ENERGY_SHIELD, 100},
+		{StatType::ATTACK, 10}
+	});
+	results.push_back(runBenchmark("Mech::takeDamage", [&]() {
+		target.takeDamage(1.0);
+		if (!target.isAlive()) target.resetCombatState();
+	}));
+
+	return results;
+}
+
+int main(int argc, char* argv[]) {
+	std::string output_path = (argc > 1) ? argv[1] : "";
+
+	// Silence engine logging, results are written with the original buffer
+	NullBuffer null_buffer;
+	std::streambuf* cout_buffer = std::cout.rdbuf(&null_buffer);
+	std::streambuf* cerr_buffer = std::cerr.rdbuf(&null_buffer);
+
+	std::vector<BenchResult> results;
+	try {
+		results = runBenchmarks();
+	} catch (const std::exception& e) {
+		std::cerr.rdbuf(cerr_buffer);
+		std::cerr << "Benchmarks failed: " << e.what() << std::endl;
+		return 1;
+	}
+
+	std::cout.rdbuf(cout_buffer);
+	std::cerr.rdbuf(cerr_buffer);
+
+	json report = json::object();
+	report["benchmarks"] = json::array();
+	for (const auto& r : results) {
+		report["benchmarks"].push_back(benchResultToJson(r));
+	}
+
+	if (output_path.empty()) {
+		std::cout << report.dump(4) << std::endl;
+	} else {
+		std::ofstream out(output_path);
+		if (!out.is_open()) {
+			std::cerr << "Failed to open output file: " << output_path << std::endl;
+			return 1;
+		}
+		out << report.dump(4) << std::endl;
+		std::cout << "Wrote " << results.size() << " benchmark results to " << output_path << std::endl;
+	}
+	return 0;
+}
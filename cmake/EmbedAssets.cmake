@@ -0,0 +1,55 @@
+# Converts every file under data/ and web/ into a C++ byte array table (see src/EmbeddedAssets.h)
+# Usage: cmake -DROOT=<project source dir> -DDATA_PACK=<compiled game_data.pack> -DOUTPUT=<generated .cpp> -P EmbedAssets.cmake
+# The compiled pack is embedded as data/game_data.pack, replacing any stale copy under data/
+
+file(GLOB_RECURSE EMBED_FILES
+	LIST_DIRECTORIES false
+	RELATIVE "${ROOT}"
+	"${ROOT}/data/*"
+	"${ROOT}/web/*"
+)
+list(REMOVE_ITEM EMBED_FILES "data/game_data.pack")
+if(DATA_PACK)
+	list(APPEND EMBED_FILES "data/game_data.pack")
+endif()
+list(SORT EMBED_FILES)
+
+set(GENERATED "// Generated by cmake/EmbedAssets.cmake, do not edit.\n")
+string(APPEND GENERATED "#include \"EmbeddedAssets.h\"\n\n")
+
+set(TABLE "")
+set(INDEX 0)
+foreach(RELATIVE_FILE ${EMBED_FILES})
+	set(SOURCE_FILE "${ROOT}/${RELATIVE_FILE}")
+	if(RELATIVE_FILE STREQUAL "data/game_data.pack")
+		set(SOURCE_FILE "${DATA_PACK}") # Built in the binary directory
+	endif()
+	file(READ "${SOURCE_FILE}" HEX_CONTENT HEX)
+	file(SIZE "${SOURCE_FILE}" FILE_SIZE)
+
+	# "0a1b..." -> "0x0a,0x1b,...", one line per 32 bytes to keep the generated file diffable
+	string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," BYTES "${HEX_CONTENT}")
+	string(REGEX REPLACE "((0x[0-9a-f][0-9a-f],){32})" "\\1\n\t" BYTES "${BYTES}")
+
+	# An empty file still needs one element, the table keeps the real size
+	if(FILE_SIZE EQUAL 0)
+		set(BYTES "0x00,")
+	endif()
+
+	# Aligned so the pack can be used in place (DataPack::openBytes requires 8 bytes)
+	string(APPEND GENERATED "alignas(8) static const unsigned char embedded_asset_${INDEX}[] = {\n\t${BYTES}\n};\n\n")
+	string(APPEND TABLE "\t{\"${RELATIVE_FILE}\", embedded_asset_${INDEX}, ${FILE_SIZE}},\n")
+	math(EXPR INDEX "${INDEX} + 1")
+endforeach()
+
+string(APPEND GENERATED "extern const EmbeddedAsset embedded_assets[] = {\n${TABLE}};\n\n")
+string(APPEND GENERATED "extern const size_t embedded_asset_count = ${INDEX};\n")
+
+# Only touch the output when something changed so dependent objects aren't rebuilt needlessly
+if(EXISTS "${OUTPUT}")
+	file(READ "${OUTPUT}" EXISTING)
+	if(EXISTING STREQUAL GENERATED)
+		return()
+	endif()
+endif()
+file(WRITE "${OUTPUT}" "${GENERATED}")
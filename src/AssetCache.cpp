@@ -0,0 +1,224 @@
+#include <iostream>
+#include <filesystem>
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+#include <ctime>
+#include <cstdint>
+#include <cstdio>
+
+#include "AssetCache.h"
+#include "EmbeddedAssets.h"
+#include "MappedFile.h"
+
+namespace {
+
+// 64-bit FNV-1a, plenty for telling asset versions apart
+std::string contentHash(std::string_view data) {
+	uint64_t hash = 1469598103934665603ULL;
+	for (unsigned char c : data) {
+		hash ^= c;
+		hash *= 1099511628211ULL;
+	}
+	char hex[17];
+	std::snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(hash));
+	return std::string(hex);
+}
+
+std::string httpDate(time_t t) {
+	char buf[64];
+	std::tm tm_utc{};
+	gmtime_r(&t, &tm_utc);
+	std::strftime(buf, sizeof(buf), "%a, %d %b %Y %H:%M:%S GMT", &tm_utc);
+	return std::string(buf);
+}
+
+} // namespace
+
+size_t AssetCache::loadDirectory(const std::string& root_dir) {
+	namespace fs = std::filesystem;
+
+	std::unordered_map<std::string, CachedAsset> loaded;
+	size_t identity_bytes = 0;
+	size_t best_bytes = 0;
+
+	auto addAsset = [&](CachedAsset asset) {
+		identity_bytes += asset.identity.size();
+		best_bytes += std::min({asset.identity.size(),
+			asset.gzip.empty() ? asset.identity.size() : asset.gzip.size(),
+			asset.brotli.empty() ? asset.identity.size() : asset.brotli.size()});
+		std::string key = asset.path;
+		loaded[key] = std::move(asset);
+	};
+
+	// Embedded build: serve straight out of the binary's read-only data, nothing is read from disk
+	std::vector<const EmbeddedAsset*> embedded = listEmbeddedAssets(root_dir + "/");
+	if (!embedded.empty()) {
+		time_t build_time = std::time(nullptr); // Embedded files have no mtime, the process start is as good as any
+		for (const EmbeddedAsset* entry : embedded) {
+			std::string path = std::string(entry->path).substr(root_dir.size() + 1);
+			std::string_view contents(reinterpret_cast<const char*>(entry->data), entry->size);
+			addAsset(makeAssetView(path, contents, build_time));
+		}
+
+		assets = std::move(loaded);
+		std::cout << "AssetCache: cached " << assets.size() << " embedded files from " << root_dir << " (" << identity_bytes << " bytes, " << best_bytes << " bytes compressed)" << std::endl;
+		return assets.size();
+	}
+
+	if (!fs::is_directory(root_dir)) {
+		throw std::runtime_error("AssetCache: web root not found: " + root_dir);
+	}
+
+	for (const auto& entry : fs::recursive_directory_iterator(root_dir)) {
+		if (!entry.is_regular_file()) continue;
+
+		std::string path = fs::relative(entry.path(), root_dir).generic_string();
+
+		MappedFile mapped;
+		if (!mapFile(entry.path().string(), mapped)) {
+			std::cerr << "AssetCache: failed to map " << entry.path() << std::endl;
+			continue;
+		}
+		CachedAsset asset = makeAssetView(path, mapped.contents, mapped.modified);
+		asset.storage = std::move(mapped.mapping);
+		addAsset(std::move(asset));
+	}
+
+	assets = std::move(loaded);
+	std::cout << "AssetCache: cached " << assets.size() << " files from " << root_dir << " (" << identity_bytes << " bytes, " << best_bytes << " bytes compressed)" << std::endl;
+	return assets.size();
+}
+
+CachedAsset AssetCache::makeAsset(const std::string& path, std::string content, time_t modified) {
+	auto owned = std::make_shared<const std::string>(std::move(content));
+	CachedAsset asset = makeAssetView(path, *owned, modified);
+	asset.storage = owned;
+	return asset;
+}
+
+CachedAsset AssetCache::makeAssetView(const std::string& path, std::string_view content, time_t modified) {
+	CachedAsset asset;
+	asset.path = path;
+	asset.content_type = contentTypeFor(path);
+	asset.identity = content;
+
+	asset.hash = contentHash(asset.identity);
+	asset.etag = "W/\"" + asset.hash + "\""; // Weak, so one tag covers every encoding of the same content
+	asset.last_modified = httpDate(modified);
+
+	if (isCompressible(asset.content_type) && !asset.identity.empty()) {
+		asset.gzip = gzipCompress(asset.identity);
+		if (asset.gzip.size() >= asset.identity.size()) asset.gzip.clear();
+
+		asset.brotli = brotliCompress(asset.identity);
+		if (asset.brotli.size() >= asset.identity.size()) asset.brotli.clear();
+	}
+	return asset;
+}
+
+const CachedAsset* AssetCache::find(const std::string& relative_path) const {
+	auto it = assets.find(relative_path);
+	return (it != assets.end()) ? &it->second : nullptr;
+}
+
+bool AssetCache::isNotModified(const CachedAsset& asset, const std::string& if_none_match, const std::string& if_modified_since) {
+	// If-None-Match takes precedence over If-Modified-Since (RFC 9110 13.2.2)
+	if (!if_none_match.empty()) {
+		if (if_none_match.find('*') != std::string::npos) return true;
+
+		// Weak comparison: only the quoted opaque tag matters, with or without a W/ prefix
+		std::string quoted_hash = "\"" + asset.hash + "\"";
+		size_t pos = 0;
+		while ((pos = if_none_match.find('"', pos)) != std::string::npos) {
+			size_t end = if_none_match.find('"', pos + 1);
+			if (end == std::string::npos) break;
+			if (if_none_match.compare(pos, end - pos + 1, quoted_hash) == 0) return true;
+			pos = end + 1;
+		}
+		return false;
+	}
+
+	// Browsers echo back the exact Last-Modified value they were given
+	return !if_modified_since.empty() && if_modified_since == asset.last_modified;
+}
+
+RangeResult AssetCache::parseRange(const std::string& range, size_t size, size_t& first, size_t& last) {
+	const std::string unit = "bytes=";
+	if (range.compare(0, unit.size(), unit) != 0) return RangeResult::FULL;
+
+	std::string spec = range.substr(unit.size());
+	spec.erase(std::remove_if(spec.begin(), spec.end(), [](unsigned char c) { return std::isspace(c); }), spec.end());
+	size_t dash = spec.find('-');
+	if (dash == std::string::npos || spec.find(',') != std::string::npos) return RangeResult::FULL; // Malformed or multipart, send it all
+
+	std::string start_str = spec.substr(0, dash);
+	std::string end_str = spec.substr(dash + 1);
+	auto is_number = [](const std::string& str) {
+		return !str.empty() && str.size() <= 18 && std::all_of(str.begin(), str.end(), [](unsigned char c) { return std::isdigit(c); });
+	};
+
+	if (start_str.empty()) {
+		// Suffix range, the last N bytes
+		if (!is_number(end_str)) return RangeResult::FULL;
+		size_t suffix = std::stoull(end_str);
+		if (suffix == 0 || size == 0) return RangeResult::UNSATISFIABLE;
+		first = (suffix >= size) ? 0 : size - suffix;
+		last = size - 1;
+		return RangeResult::PARTIAL;
+	}
+
+	if (!is_number(start_str) || (!end_str.empty() && !is_number(end_str))) return RangeResult::FULL;
+	first = std::stoull(start_str);
+	if (first >= size) return RangeResult::UNSATISFIABLE;
+	last = end_str.empty() ? size - 1 : std::min<size_t>(std::stoull(end_str), size - 1);
+	if (last < first) return RangeResult::FULL; // Syntactically invalid, ignored per RFC 9110 14.1.1
+	return RangeResult::PARTIAL;
+}
+
+bool AssetCache::isRangeValid(const CachedAsset& asset, const std::string& if_range) {
+	if (if_range.empty()) return true;
+	// If-Range needs a strong match, the weak ETag we hand out never qualifies but its date does
+	return if_range == asset.last_modified || if_range == "\"" + asset.hash + "\"";
+}
+
+std::string_view AssetCache::selectVariant(const CachedAsset& asset, const std::string& accept_encoding, ContentEncoding& encoding) {
+	if (!asset.brotli.empty() && acceptsEncoding(accept_encoding, "br")) {
+		encoding = ContentEncoding::BROTLI;
+		return asset.brotli;
+	}
+	if (!asset.gzip.empty() && acceptsEncoding(accept_encoding, "gzip")) {
+		encoding = ContentEncoding::GZIP;
+		return asset.gzip;
+	}
+	encoding = ContentEncoding::IDENTITY;
+	return asset.identity;
+}
+
+std::string AssetCache::contentTypeFor(const std::string& path) {
+	std::string ext;
+	size_t dot = path.find_last_of('.');
+	if (dot != std::string::npos) {
+		ext = path.substr(dot + 1);
+		std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return std::tolower(c); });
+	}
+
+	if (ext == "html" || ext == "htm") return "text/html; charset=utf-8";
+	if (ext == "js") return "text/javascript";
+	if (ext == "css") return "text/css";
+	if (ext == "json") return "application/json";
+	if (ext == "svg") return "image/svg+xml";
+	if (ext == "jpg" || ext == "jpeg") return "image/jpeg";
+	if (ext == "png") return "image/png";
+	if (ext == "gif") return "image/gif";
+	if (ext == "webp") return "image/webp";
+	if (ext == "ico") return "image/x-icon";
+	if (ext == "txt") return "text/plain; charset=utf-8";
+	return "application/octet-stream";
+}
+
+bool AssetCache::isCompressible(const std::string& content_type) {
+	return content_type.compare(0, 5, "text/") == 0
+		|| content_type == "application/json"
+		|| content_type == "image/svg+xml";
+}
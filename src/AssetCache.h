@@ -0,0 +1,78 @@
+#ifndef ASSETCACHE_H
+#define ASSETCACHE_H
+
+#include <string>
+#include <string_view>
+#include <memory>
+#include <unordered_map>
+#include <ctime>
+
+#include "Compression.h"
+
+/* In-memory static asset cache
+	Every file under the web root is memory-mapped once at startup, so large media is paged in by
+	the kernel on demand instead of being copied onto the heap. Text assets (js, css, html, json, svg)
+	also get gzip and brotli variants precomputed, kept only when smaller than the original.
+	Requests are then served straight from memory with the best encoding the client accepts.
+
+	Keys are paths relative to the web root using '/', e.g. "script.js" or "media/enemy_grunt_mech_00.jpg".
+
+	Caching: each asset carries a content-hash ETag and Last-Modified computed at load time, so
+	conditional requests are answered with 304 without touching the body. Pages link assets with
+	a `?v=<hash>` suffix, which lets those URLs be cached as immutable.
+
+	Range requests: a single `bytes=` range is served as 206 from the identity bytes, so media can
+	be seeked and resumed without sending the whole file.
+*/
+
+enum class RangeResult { FULL, PARTIAL, UNSATISFIABLE };
+
+struct CachedAsset {
+	std::string path;
+	std::string content_type;
+	std::string_view identity; // The original bytes, see `storage`
+	std::shared_ptr<const void> storage; // Keeps `identity` alive (heap copy or file mapping), null for data embedded in the binary
+	std::string gzip;   // Empty if not compressible or not smaller
+	std::string brotli; // Empty if not compressible, not smaller or brotli isn't available
+
+	std::string hash;          // Hex content hash, used as the `?v=` cache buster
+	std::string etag;          // Weak ETag built from `hash`
+	std::string last_modified; // HTTP-date of the file's mtime
+};
+
+class AssetCache {
+public:
+	// Loads (or reloads) every file under `root_dir`. Returns the number of files cached.
+	// In IDLE_MECH_EMBED_ASSETS builds the files come from the binary instead of the disk.
+	size_t loadDirectory(const std::string& root_dir);
+
+	const CachedAsset* find(const std::string& relative_path) const;
+	size_t size() const { return assets.size(); }
+	const std::unordered_map<std::string, CachedAsset>& getAssets() const { return assets; }
+
+	// True if the request's validators still match, i.e. it can be answered with 304 Not Modified
+	static bool isNotModified(const CachedAsset& asset, const std::string& if_none_match, const std::string& if_modified_since);
+
+	// Parses a Range header against an asset of `size` bytes. PARTIAL fills the inclusive byte range [first, last].
+	// Anything this server doesn't serve as a range (missing header, other units, multiple ranges) is FULL.
+	static RangeResult parseRange(const std::string& range, size_t size, size_t& first, size_t& last);
+
+	// True if an If-Range validator still matches, i.e. the Range header can be honoured
+	static bool isRangeValid(const CachedAsset& asset, const std::string& if_range);
+
+	// Picks the smallest variant the client accepts and reports which encoding it is
+	static std::string_view selectVariant(const CachedAsset& asset, const std::string& accept_encoding, ContentEncoding& encoding);
+
+	// Builds a cache entry (hash, validators, compressed variants) for in-memory content
+	static CachedAsset makeAsset(const std::string& path, std::string content, time_t modified);
+	// Same, but references bytes that outlive the entry (embedded in the binary, or kept alive via `storage`) without copying them
+	static CachedAsset makeAssetView(const std::string& path, std::string_view content, time_t modified);
+
+	static std::string contentTypeFor(const std::string& path); // MIME type from the file extension
+	static bool isCompressible(const std::string& content_type);
+
+private:
+	std::unordered_map<std::string, CachedAsset> assets;
+};
+
+#endif // ASSETCACHE_H
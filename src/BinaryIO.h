@@ -0,0 +1,166 @@
+#ifndef BINARYIO_H
+#define BINARYIO_H
+
+#include <string>
+#include <string_view>
+#include <stdexcept>
+#include <cstring>
+#include <cstdint>
+#include <cerrno>
+
+#include <unistd.h>
+#include <zlib.h> // crc32
+
+#include "Stats.h"
+#include "SaveGame.h"
+
+/* Little-endian encoding shared by save snapshots and the event journal
+	Strings are u32 length + bytes, doubles are their IEEE-754 bits, Stats are a u8 count of
+	(u8 StatType, f64 value) pairs. Enum values unknown to this build (written by a newer one)
+	are dropped or mapped to a safe default on read.
+*/
+
+// Highest value of each enum this build knows, from the X-macro tables so a new value is picked up by itself
+constexpr int LAST_STAT_TYPE = static_cast<int>(STAT_TYPE_NAMES.size()) - 1;
+constexpr int LAST_EQUIPMENT_SLOT = static_cast<int>(EquipmentSlot::NONE) - 1; // NONE is not a slot an item can go in
+constexpr int LAST_RARITY = static_cast<int>(RARITY_NAMES.size()) - 1;
+
+class ByteWriter {
+public:
+	explicit ByteWriter(std::string& out) : out(out) {}
+
+	void u8(uint8_t v) { out.push_back(static_cast<char>(v)); }
+	void u16(uint16_t v) { writeLE(v, 2); }
+	void u32(uint32_t v) { writeLE(v, 4); }
+	void u64(uint64_t v) { writeLE(v, 8); }
+	void i32(int32_t v) { u32(static_cast<uint32_t>(v)); }
+	void f64(double v) {
+		uint64_t bits;
+		std::memcpy(&bits, &v, sizeof(bits));
+		u64(bits);
+	}
+	void str(const std::string& s) {
+		u32(static_cast<uint32_t>(s.size()));
+		out.append(s);
+	}
+	void stats(const Stats& stats) {
+		u8(static_cast<uint8_t>(stats.size()));
+		for (const auto& [type, value] : stats) {
+			u8(static_cast<uint8_t>(type));
+			f64(value);
+		}
+	}
+	void item(const SavedItem& item) {
+		str(item.template_id);
+		u8(static_cast<uint8_t>(item.rarity));
+		stats(item.stats);
+	}
+
+	// Reserves a u32 to be filled in later with patchU32, e.g. a length that isn't known yet
+	size_t placeholderU32() {
+		size_t pos = out.size();
+		u32(0);
+		return pos;
+	}
+	void patchU32(size_t pos, uint32_t v) {
+		for (int i = 0; i < 4; i++) {
+			out[pos + i] = static_cast<char>((v >> (8 * i)) & 0xFF);
+		}
+	}
+	size_t size() const { return out.size(); }
+
+private:
+	void writeLE(uint64_t v, int bytes) {
+		char buf[8];
+		for (int i = 0; i < bytes; i++) {
+			buf[i] = static_cast<char>((v >> (8 * i)) & 0xFF);
+		}
+		out.append(buf, bytes);
+	}
+
+	std::string& out;
+};
+
+class ByteReader {
+public:
+	explicit ByteReader(std::string_view data) : data(data) {}
+
+	bool atEnd() const { return pos >= data.size(); }
+
+	uint8_t u8() { return static_cast<uint8_t>(readLE(1)); }
+	uint16_t u16() { return static_cast<uint16_t>(readLE(2)); }
+	uint32_t u32() { return static_cast<uint32_t>(readLE(4)); }
+	uint64_t u64() { return readLE(8); }
+	int32_t i32() { return static_cast<int32_t>(u32()); }
+	double f64() {
+		uint64_t bits = u64();
+		double v;
+		std::memcpy(&v, &bits, sizeof(v));
+		return v;
+	}
+	std::string str() {
+		uint32_t size = u32();
+		return std::string(bytes(size));
+	}
+	Stats stats() {
+		Stats stats;
+		uint8_t count = u8();
+		for (uint8_t i = 0; i < count; i++) {
+			uint8_t type = u8();
+			double value = f64();
+			if (type <= LAST_STAT_TYPE) stats[static_cast<StatType>(type)] = value; // Stats from a newer build are dropped
+		}
+		return stats;
+	}
+	SavedItem item() {
+		SavedItem item;
+		item.template_id = str();
+		uint8_t rarity = u8();
+		item.rarity = (rarity <= LAST_RARITY) ? static_cast<Rarity>(rarity) : Rarity::COMMON;
+		item.stats = stats();
+		return item;
+	}
+
+	std::string_view bytes(size_t size) {
+		if (size > data.size() - pos) {
+			throw std::runtime_error("SaveGame: data is truncated");
+		}
+		std::string_view view = data.substr(pos, size);
+		pos += size;
+		return view;
+	}
+
+private:
+	uint64_t readLE(int size) {
+		std::string_view raw = bytes(size);
+		uint64_t v = 0;
+		for (int i = 0; i < size; i++) {
+			v |= static_cast<uint64_t>(static_cast<unsigned char>(raw[i])) << (8 * i);
+		}
+		return v;
+	}
+
+	std::string_view data;
+	size_t pos = 0;
+};
+
+
+// CRC-32 (zlib's) used to detect torn or corrupted records
+inline uint32_t checksum32(std::string_view data) {
+	return static_cast<uint32_t>(crc32(0L, reinterpret_cast<const Bytef*>(data.data()), static_cast<uInt>(data.size())));
+}
+
+// write() until everything is out, retrying on EINTR. Throws std::runtime_error on failure.
+inline void writeAll(int fd, std::string_view data, const std::string& path) {
+	size_t written = 0;
+	while (written < data.size()) {
+		ssize_t n = write(fd, data.data() + written, data.size() - written);
+		if (n < 0) {
+			if (errno == EINTR) continue;
+			throw std::runtime_error("Failed to write " + path + ": " + std::strerror(errno));
+		}
+		written += static_cast<size_t>(n);
+	}
+}
+
+#endif // BINARYIO_H
@@ -0,0 +1,111 @@
+#include <cmath>
+#include <algorithm>
+#include <climits>
+
+#include "BossGenerator.h"
+#include "StringInterner.h"
+
+namespace {
+
+// value(floor) = base * growth^(floor - 1) + per_floor * (floor - 1)
+struct ScalingCurve {
+	double base;
+	double growth;
+	double per_floor;
+
+	double at(int floor) const { return base * pow(growth, floor - 1) + per_floor * (floor - 1); }
+};
+
+// NOTE(MSR): Growth rates match the grunts (EnemyScalingTable::buildGrunt), so a generated boss stays
+// the same size relative to the floor it guards. Bases are set so the first generated floor lands
+// near the last boss in bosses.json.
+const ScalingCurve BOSS_HEALTH_CURVE        = {6000.0, 1.2, 0.0};
+const ScalingCurve BOSS_ATTACK_CURVE        = {700.0, 1.15, 0.0};
+const ScalingCurve BOSS_ARMOR_CURVE         = {12.0, 1.1, 0.0};
+const ScalingCurve BOSS_SHIELD_CURVE        = {3000.0, 1.1, 0.0};
+const ScalingCurve BOSS_MOBILITY_CURVE      = {30.0, 1.0, 1.0};
+const ScalingCurve BOSS_ATTACK_SPEED_CURVE  = {1.5, 1.0, 0.05};
+const ScalingCurve BOSS_REPAIR_CURVE        = {50.0, 1.15, 0.0};
+const ScalingCurve BOSS_EXP_CURVE           = {100.0, 1.0, 20.0}; // Linear, bosses.json doubles per floor but that overflows an int long before floor 500
+
+struct BossArchetype {
+	const char* chassis;
+	// Multipliers on the curves above
+	double health, attack, armor, shield, mobility, attack_speed, repair, exp;
+};
+
+const BossArchetype BOSS_ARCHETYPES[] = {
+	// chassis        health  attack  armor  shield  mobility  atk spd  repair  exp
+	{"Juggernaut",    1.6,    0.8,    1.8,   0.7,    0.5,      0.7,     1.0,    1.2},
+	{"Skirmisher",    0.7,    1.1,    0.6,   0.8,    1.8,      1.5,     0.5,    1.0},
+	{"Bastion",       1.1,    0.7,    1.2,   2.0,    0.6,      0.8,     1.5,    1.1},
+	{"Executioner",   0.8,    1.6,    0.8,   0.6,    1.1,      1.0,     0.3,    1.3},
+	{"Warden",        1.0,    1.0,    1.0,   1.0,    1.0,      1.0,     1.0,    1.0},
+	{"Revenant",      0.9,    1.2,    0.7,   0.9,    1.2,      1.1,     2.5,    1.2},
+};
+
+const char* const BOSS_TITLES[] = {
+	"Iron", "Crimson", "Hollow", "Storm", "Ashen", "Obsidian", "Feral", "Silent", "Gilded", "Rust"
+};
+
+// splitmix64, every call moves `state` on and returns the next well-mixed value
+uint64_t nextHash(uint64_t& state) {
+	uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+// Uniform in [1 - BOSS_STAT_VARIANCE, 1 + BOSS_STAT_VARIANCE)
+double nextVariance(uint64_t& state) {
+	double unit = (nextHash(state) >> 11) * (1.0 / 9007199254740992.0); // 53 bits -> [0, 1)
+	return 1.0 + BOSS_STAT_VARIANCE * (2.0 * unit - 1.0);
+}
+
+} // namespace
+
+BossGenerator::BossGenerator(size_t capacity) : capacity(std::max<size_t>(1, capacity)) {}
+
+BossData BossGenerator::generate(unsigned int seed, int floor) {
+	floor = std::max(1, floor);
+	uint64_t state = (static_cast<uint64_t>(seed) << 32) ^ static_cast<uint32_t>(floor);
+
+	const size_t archetype_count = sizeof(BOSS_ARCHETYPES) / sizeof(BOSS_ARCHETYPES[0]);
+	const size_t title_count = sizeof(BOSS_TITLES) / sizeof(BOSS_TITLES[0]);
+	const BossArchetype& archetype = BOSS_ARCHETYPES[nextHash(state) % archetype_count];
+	const char* title = BOSS_TITLES[nextHash(state) % title_count];
+
+	BossData boss;
+	boss.name = internName(std::string(title) + " " + archetype.chassis + " Mk." + std::to_string(floor));
+	boss.stats[StatType::HEALTH]        = BOSS_HEALTH_CURVE.at(floor) * archetype.health * nextVariance(state);
+	boss.stats[StatType::ATTACK]        = BOSS_ATTACK_CURVE.at(floor) * archetype.attack * nextVariance(state);
+	boss.stats[StatType::ARMOR]         = std::max(1.0, BOSS_ARMOR_CURVE.at(floor) * archetype.armor * nextVariance(state));
+	boss.stats[StatType::ENERGY_SHIELD] = BOSS_SHIELD_CURVE.at(floor) * archetype.shield * nextVariance(state);
+	boss.stats[StatType::MOBILITY]      = BOSS_MOBILITY_CURVE.at(floor) * archetype.mobility * nextVariance(state);
+	boss.stats[StatType::ATTACK_SPEED]  = BOSS_ATTACK_SPEED_CURVE.at(floor) * archetype.attack_speed * nextVariance(state);
+	boss.stats[StatType::REPAIR]        = BOSS_REPAIR_CURVE.at(floor) * archetype.repair * nextVariance(state);
+	boss.exp_reward = static_cast<int>(std::min<double>(INT_MAX, BOSS_EXP_CURVE.at(floor) * archetype.exp));
+	return boss;
+}
+
+const BossData& BossGenerator::get(unsigned int seed, int floor) {
+	if (seed != cached_seed) { // A new session, none of the cached bosses are its bosses
+		entries.clear();
+		by_floor.clear();
+		cached_seed = seed;
+	}
+
+	auto it = by_floor.find(floor);
+	if (it != by_floor.end()) {
+		entries.splice(entries.begin(), entries, it->second);
+		return it->second->second;
+	}
+
+	if (entries.size() >= capacity) {
+		by_floor.erase(entries.back().first);
+		entries.pop_back();
+	}
+	entries.emplace_front(floor, generate(seed, floor));
+	by_floor[floor] = entries.begin();
+	return entries.front().second;
+}
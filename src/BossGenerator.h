@@ -0,0 +1,51 @@
+#ifndef BOSSGENERATOR_H
+#define BOSSGENERATOR_H
+
+#include <string_view>
+#include <list>
+#include <unordered_map>
+#include <cstdint>
+
+#include "Stats.h"
+
+#define BOSS_CACHE_CAPACITY 64 // Generated floors kept around, a player only ever moves one floor at a time
+#define BOSS_STAT_VARIANCE 0.1 // Each generated stat lands within +-10% of its archetype value
+
+struct BossData {
+	std::string_view name; // Interned, see StringInterner.h
+	Stats stats;
+	int exp_reward;
+};
+
+/* Procedural bosses
+	bosses.json covers the first few floors. Every floor past it gets a boss built from an archetype
+	(a chassis with its own stat profile, see BOSS_ARCHETYPES) on top of per-stat scaling curves that
+	grow at the same rate as the grunts of that floor.
+
+	A boss depends only on (session seed, floor): the same save or recording meets the same bosses,
+	and nothing is drawn from the game RNG, so spawning one doesn't shift the loot rolls after it.
+
+	Generated bosses are memoized in a small LRU cache. Reaching floor 500 costs one generation per
+	floor, not a table of 500 entries.
+*/
+class BossGenerator {
+public:
+	explicit BossGenerator(size_t capacity = BOSS_CACHE_CAPACITY);
+
+	// The boss for `floor` in a session seeded with `seed`. The reference is valid until the next call.
+	const BossData& get(unsigned int seed, int floor);
+
+	size_t getCachedCount() const { return entries.size(); }
+
+	static BossData generate(unsigned int seed, int floor);
+
+private:
+	using Entry = std::pair<int, BossData>; // Floor, boss
+
+	size_t capacity;
+	unsigned int cached_seed = 0;
+	std::list<Entry> entries; // Most recently used first
+	std::unordered_map<int, std::list<Entry>::iterator> by_floor;
+};
+
+#endif // BOSSGENERATOR_H
@@ -0,0 +1,132 @@
+#include <cmath>
+#include <algorithm>
+
+#include "CombatResolver.h"
+
+namespace {
+
+// Same clamp and formula as Mech::takeDamage
+double armorMultiplier(double armor) {
+	double armor_value = std::max(1.0, std::min(9999.0, armor));
+	return 1 - (armor_value / 9999);
+}
+
+// Relative distance from an integer below which the division is not trusted
+const double BOUNDARY_EPSILON = 1e-9;
+
+struct HitCount {
+	long long hits = 0;
+	double last_remaining = 0; // Value left in the pool right before the final hit
+};
+
+/* Number of hits of `step` that drain `pool`.
+	Shield: a hit drains it once the remaining shield is <= step (`drain_at_step` = true).
+	HP: a hit drains it once the remaining HP is <= 0 after the subtraction.
+	Both reduce to ceil(pool / step); near integer quotients the subtractions are replayed.
+*/
+HitCount countHits(double pool, double step, bool drain_at_step) {
+	HitCount count;
+	double q = pool / step;
+	double k = std::ceil(q);
+
+	bool near_boundary = (k - q) < BOUNDARY_EPSILON * std::max(1.0, k) || (q - (k - 1)) < BOUNDARY_EPSILON * std::max(1.0, k);
+	if (!near_boundary) {
+		count.hits = std::max(1LL, static_cast<long long>(k));
+		count.last_remaining = pool - (count.hits - 1) * step;
+		return count;
+	}
+
+	double remaining = pool;
+	count.hits = 1;
+	if (drain_at_step) {
+		while (remaining > step) {
+			remaining -= step;
+			count.hits++;
+		}
+	} else {
+		while (remaining - step > 0) {
+			remaining -= step;
+			count.hits++;
+		}
+	}
+	count.last_remaining = remaining;
+	return count;
+}
+
+} // namespace
+
+long long hitsToDefeat(const CombatantState& defender, double damage) {
+	if (defender.hp <= 0) return 0;
+	if (damage <= 0) return -1;
+
+	double hp_damage_per_hit = damage * armorMultiplier(defender.armor);
+	long long hits = 0;
+	double hp = defender.hp;
+
+	if (defender.energy_shield > 0) {
+		HitCount shield_hits = countHits(defender.energy_shield, damage, true);
+		hits = shield_hits.hits;
+
+		// The hit that breaks the shield spills over into HP
+		double overflow = (damage - shield_hits.last_remaining) * armorMultiplier(defender.armor);
+		if (overflow > 0) hp -= overflow;
+		if (hp <= 0) return hits;
+	}
+
+	if (hp_damage_per_hit <= 0) return -1; // Armor soaks everything once the shield is down
+	return hits + countHits(hp, hp_damage_per_hit, false).hits;
+}
+
+CombatantState applyHits(CombatantState defender, double damage, long long hits) {
+	if (hits <= 0 || damage <= 0 || defender.hp <= 0) return defender;
+
+	double multiplier = armorMultiplier(defender.armor);
+	if (defender.energy_shield > 0) {
+		HitCount shield_hits = countHits(defender.energy_shield, damage, true);
+		if (hits < shield_hits.hits) {
+			defender.energy_shield -= hits * damage;
+			return defender;
+		}
+
+		double overflow = (damage - shield_hits.last_remaining) * multiplier;
+		defender.energy_shield = 0;
+		if (overflow > 0) defender.hp -= overflow;
+		hits -= shield_hits.hits;
+	}
+
+	double hp_damage_per_hit = damage * multiplier;
+	if (hp_damage_per_hit > 0) {
+		defender.hp -= hits * hp_damage_per_hit;
+	}
+	defender.hp = std::max(0.0, defender.hp);
+	return defender;
+}
+
+FightResolution resolveFight(const CombatantState& first, const CombatantState& second) {
+	FightResolution result;
+	result.first_attacker = first;
+	result.second_attacker = second;
+
+	long long first_needs = hitsToDefeat(second, first.attack); // Hits `first` must land
+	long long second_needs = hitsToDefeat(first, second.attack); // Hits `second` must land
+	if (first_needs < 0 && second_needs < 0) {
+		return result; // Stalemate, leave it to the regular combat loop
+	}
+
+	result.resolvable = true;
+	// `first` lands hit k on exchange 2k-1, `second` lands hit k on exchange 2k
+	if (second_needs < 0 || (first_needs >= 0 && first_needs <= second_needs)) {
+		result.first_attacker_wins = true;
+		result.exchanges = std::max(1LL, 2 * first_needs - 1); // A defender already at 0 HP still takes the opening exchange
+		result.first_attacker = applyHits(first, second.attack, first_needs - 1);
+		result.second_attacker.hp = 0;
+		result.second_attacker.energy_shield = 0;
+	} else {
+		result.first_attacker_wins = false;
+		result.exchanges = 2 * second_needs;
+		result.first_attacker.hp = 0;
+		result.first_attacker.energy_shield = 0;
+		result.second_attacker = applyHits(second, first.attack, second_needs);
+	}
+	return result;
+}
@@ -0,0 +1,39 @@
+#ifndef COMBATRESOLVER_H
+#define COMBATRESOLVER_H
+
+/* Closed-form fight resolution
+	Turns strictly alternate and every attack deals the attacker's flat ATTACK stat, so the
+	outcome of a fight does not depend on tick timing. Given the current combat state of both
+	mechs these helpers compute how many hits each side survives, who lands the killing blow,
+	and the state of the survivor, using the same shield -> armor -> HP rules as Mech::takeDamage.
+
+	Counts are computed with a division; when the quotient lands on an integer boundary the hits
+	are replayed with the exact same subtractions Mech::takeDamage performs, so the winner and the
+	number of exchanges always agree with stepping through `handleCombat`.
+*/
+
+struct CombatantState {
+	double hp = 0;
+	double energy_shield = 0;
+	double armor = 0;
+	double attack = 0;
+};
+
+struct FightResolution {
+	bool resolvable = false; // False if neither side can ever defeat the other
+	bool first_attacker_wins = false;
+	long long exchanges = 0; // Total attacks made, including the killing blow
+	CombatantState first_attacker; // End state of the side whose turn it was
+	CombatantState second_attacker;
+};
+
+// Number of hits of `damage` needed to defeat `defender`. Returns -1 if it can never be defeated.
+long long hitsToDefeat(const CombatantState& defender, double damage);
+
+// State of `defender` after taking `hits` hits of `damage`
+CombatantState applyHits(CombatantState defender, double damage, long long hits);
+
+// Resolves a fight where `first` attacks next and the two sides alternate from there
+FightResolution resolveFight(const CombatantState& first, const CombatantState& second);
+
+#endif // COMBATRESOLVER_H
@@ -0,0 +1,148 @@
+#include <stdexcept>
+#include <cctype>
+#include <cstdlib>
+
+#include <zlib.h>
+#ifdef IDLE_MECH_HAVE_BROTLI
+#include <brotli/encode.h>
+#endif
+
+#include "Compression.h"
+
+namespace {
+
+// A deflate stream reused for every call on one thread. deflateInit allocates roughly 256 KB of
+// window and hash tables, deflateReset only clears them.
+class DeflateContext {
+public:
+	explicit DeflateContext(int window_bits) : window_bits(window_bits) {}
+	~DeflateContext() {
+		if (initialized) deflateEnd(&stream);
+	}
+	DeflateContext(const DeflateContext&) = delete;
+	DeflateContext& operator=(const DeflateContext&) = delete;
+
+	std::string compress(std::string_view data, int level) {
+		if (initialized && level == current_level) {
+			deflateReset(&stream);
+		} else {
+			if (initialized) deflateEnd(&stream);
+			stream = z_stream{};
+			initialized = deflateInit2(&stream, level, Z_DEFLATED, window_bits, 8, Z_DEFAULT_STRATEGY) == Z_OK;
+			if (!initialized) {
+				throw std::runtime_error("DeflateContext: deflateInit2 failed");
+			}
+			current_level = level;
+		}
+
+		std::string out;
+		out.resize(deflateBound(&stream, static_cast<uLong>(data.size())) + 32);
+		stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+		stream.avail_in = static_cast<uInt>(data.size());
+		stream.next_out = reinterpret_cast<Bytef*>(&out[0]);
+		stream.avail_out = static_cast<uInt>(out.size());
+
+		int result = deflate(&stream, Z_FINISH);
+		out.resize(stream.total_out);
+		if (result != Z_STREAM_END) {
+			deflateEnd(&stream);
+			initialized = false;
+			throw std::runtime_error("DeflateContext: deflate did not finish");
+		}
+		return out;
+	}
+
+private:
+	z_stream stream{};
+	int window_bits;
+	int current_level = 0;
+	bool initialized = false;
+};
+
+} // namespace
+
+std::string gzipCompress(std::string_view data, int level) {
+	// 15 window bits + 16 selects the gzip wrapper instead of raw zlib
+	thread_local DeflateContext context(15 + 16);
+	return context.compress(data, level);
+}
+
+std::string deflateCompress(std::string_view data, int level) {
+	thread_local DeflateContext context(15);
+	return context.compress(data, level);
+}
+
+bool isBrotliAvailable() {
+#ifdef IDLE_MECH_HAVE_BROTLI
+	return true;
+#else
+	return false;
+#endif
+}
+
+std::string brotliCompress(std::string_view data, int quality) {
+#ifdef IDLE_MECH_HAVE_BROTLI
+	size_t encoded_size = BrotliEncoderMaxCompressedSize(data.size());
+	if (encoded_size == 0) return "";
+
+	std::string out(encoded_size, '\0');
+	if (!BrotliEncoderCompress(quality, BROTLI_DEFAULT_WINDOW, BROTLI_MODE_GENERIC,
+			data.size(), reinterpret_cast<const uint8_t*>(data.data()),
+			&encoded_size, reinterpret_cast<uint8_t*>(&out[0]))) {
+		return "";
+	}
+	out.resize(encoded_size);
+	return out;
+#else
+	(void)data;
+	(void)quality;
+	return "";
+#endif
+}
+
+// Parses "gzip, deflate;q=0.5, br;q=0" style lists, a coding with q=0 is refused
+bool acceptsEncoding(const std::string& accept_encoding, const std::string& coding) {
+	size_t pos = 0;
+	while (pos < accept_encoding.size()) {
+		size_t end = accept_encoding.find(',', pos);
+		if (end == std::string::npos) end = accept_encoding.size();
+		std::string token = accept_encoding.substr(pos, end - pos);
+		pos = end + 1;
+
+		double q = 1.0;
+		size_t semicolon = token.find(';');
+		if (semicolon != std::string::npos) {
+			size_t q_pos = token.find("q=", semicolon);
+			if (q_pos != std::string::npos) {
+				q = std::atof(token.c_str() + q_pos + 2);
+			}
+			token = token.substr(0, semicolon);
+		}
+
+		// Trim and compare case-insensitively
+		size_t first = token.find_first_not_of(" \t");
+		size_t last = token.find_last_not_of(" \t");
+		if (first == std::string::npos) continue;
+		token = token.substr(first, last - first + 1);
+		if (token.size() != coding.size()) continue;
+
+		bool same = true;
+		for (size_t i = 0; i < token.size(); i++) {
+			if (std::tolower(static_cast<unsigned char>(token[i])) != std::tolower(static_cast<unsigned char>(coding[i]))) {
+				same = false;
+				break;
+			}
+		}
+		if (same) return q > 0.0;
+	}
+	return false;
+}
+
+const char* contentEncodingToString(ContentEncoding encoding) {
+	switch (encoding) {
+		case ContentEncoding::GZIP: return "gzip";
+		case ContentEncoding::DEFLATE: return "deflate";
+		case ContentEncoding::BROTLI: return "br";
+		default: return "identity";
+	}
+}
@@ -0,0 +1,34 @@
+#ifndef COMPRESSION_H
+#define COMPRESSION_H
+
+#include <string>
+#include <string_view>
+
+/* HTTP content-coding helpers (zlib, optionally brotli)
+	Brotli support is compiled in when CMake finds libbrotlienc (IDLE_MECH_HAVE_BROTLI).
+*/
+
+enum class ContentEncoding {
+	IDENTITY,
+	GZIP,
+	DEFLATE,
+	BROTLI
+};
+
+// Compresses `data` into a gzip member. Throws std::runtime_error on zlib failure.
+// The zlib state is kept per thread and reset between calls, so hot paths don't pay for deflateInit.
+std::string gzipCompress(std::string_view data, int level = 9);
+
+// Same, with the zlib wrapper that HTTP calls "deflate"
+std::string deflateCompress(std::string_view data, int level = 9);
+
+// Compresses `data` with brotli. Returns an empty string if brotli isn't available.
+std::string brotliCompress(std::string_view data, int quality = 11);
+bool isBrotliAvailable();
+
+// True if `accept_encoding` (an Accept-Encoding header value) allows `coding` ("gzip", "br", ...)
+bool acceptsEncoding(const std::string& accept_encoding, const std::string& coding);
+
+const char* contentEncodingToString(ContentEncoding encoding);
+
+#endif // COMPRESSION_H
@@ -0,0 +1,813 @@
+#include <stdexcept>
+#include <cstring>
+#include <vector>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <algorithm>
+#include <tuple>
+#include <iterator>
+#include <chrono>
+#include <future>
+
+#include "DataPack.h"
+#include "MappedFile.h"
+#include "BinaryIO.h"
+#include "Utils.h"
+#include "JsonStream.h"
+
+namespace {
+
+const char PACK_MAGIC[4] = {'I', 'M', 'D', 'P'};
+const uint16_t PACK_BYTE_ORDER = 0x0102;
+const size_t PACK_ALIGNMENT = 8;
+
+static_assert(sizeof(PackHeader) % PACK_ALIGNMENT == 0, "tables must start aligned");
+static_assert(sizeof(PackStat) == 16 && sizeof(PackItem) == 56 && sizeof(PackBoss) == 32 && sizeof(PackDrop) == 16 && sizeof(PackRarityTier) == 40
+	&& sizeof(PackClass) == 48,
+	"pack records changed size, bump DATA_PACK_FORMAT_VERSION");
+
+// Used when there is no loot.json: 60% Common, 25% Uncommon, 10% Rare, 5% Legendary on every floor
+const double DEFAULT_RARITY_WEIGHTS[4] = {60, 25, 10, 5};
+
+// Accumulates the tables, deduplicating strings
+class PackBuilder {
+public:
+	PackString str(const std::string& s) {
+		auto it = string_index.find(s);
+		if (it != string_index.end()) return it->second;
+		PackString ref{static_cast<uint32_t>(strings.size()), static_cast<uint32_t>(s.size())};
+		strings += s;
+		string_index.emplace(s, ref);
+		return ref;
+	}
+
+	// Appends another builder's tables, moving its references to where they land in this one.
+	// Merging parts in file order gives the same pack a single builder would have.
+	void append(const PackBuilder& part) {
+		const uint32_t stat_base = static_cast<uint32_t>(stat_table.size());
+		const uint32_t drop_base = static_cast<uint32_t>(boss_drops.size());
+		const uint32_t level_base = static_cast<uint32_t>(levels.size());
+		auto rebase = [&](const PackString& s) { return str(part.strings.substr(s.offset, s.length)); };
+
+		stat_table.insert(stat_table.end(), part.stat_table.begin(), part.stat_table.end());
+		for (PackItem item : part.items) {
+			item.id = rebase(item.id);
+			item.name = rebase(item.name);
+			item.description = rebase(item.description);
+			item.first_stat += stat_base;
+			items.push_back(item);
+		}
+		for (PackBoss boss : part.bosses) {
+			boss.name = rebase(boss.name);
+			boss.first_stat += stat_base;
+			boss.first_drop += drop_base;
+			bosses.push_back(boss);
+		}
+		boss_drops.insert(boss_drops.end(), part.boss_drops.begin(), part.boss_drops.end()); // Already index the items.json part, which goes first
+		for (PackLevelCurve curve : part.level_curves) {
+			curve.class_id = rebase(curve.class_id);
+			curve.first_level += level_base;
+			level_curves.push_back(curve);
+		}
+		levels.insert(levels.end(), part.levels.begin(), part.levels.end());
+		rarity_tiers.insert(rarity_tiers.end(), part.rarity_tiers.begin(), part.rarity_tiers.end());
+		for (PackClass pilot_class : part.classes) {
+			pilot_class.id = rebase(pilot_class.id);
+			pilot_class.name = rebase(pilot_class.name);
+			pilot_class.passive_id = rebase(pilot_class.passive_id);
+			pilot_class.passive_description = rebase(pilot_class.passive_description);
+			pilot_class.first_stat += stat_base;
+			classes.push_back(pilot_class); // level_curve already indexes the levels.json part, the only one with curves
+		}
+	}
+
+	std::string strings;
+	std::vector<PackStat> stat_table;
+	std::vector<PackItem> items;
+	std::vector<PackBoss> bosses;
+	std::vector<PackLevelCurve> level_curves;
+	std::vector<PackLevel> levels;
+	std::vector<PackDrop> boss_drops;
+	std::vector<PackRarityTier> rarity_tiers;
+	std::vector<PackClass> classes;
+
+	std::unordered_map<std::string, uint32_t> item_ids; // Item id -> index, for the bosses' drops
+	std::unordered_map<std::string, uint32_t> curve_ids; // Class id -> level curve index, for the classes
+	std::unordered_map<std::string, uint32_t> class_ids; // Class id -> index, for the level curves
+
+private:
+	std::unordered_map<std::string, PackString> string_index;
+};
+
+// NOTE(MSR): The readers below append records to the pack as the parser streams through each file,
+// no file is ever held as a json DOM. Stats and drops of an entry arrive contiguously, so an entry
+// only needs to remember where its run started.
+
+// Shared checks for the data-file readers, every error carries the file, line and column
+class PackReader : public JsonStreamReader {
+public:
+	PackReader(const char* file, PackBuilder& pack) : JsonStreamReader(file), pack(pack) {}
+
+protected:
+	std::string requireString(const json& value, const std::string& where) {
+		if (!value.is_string()) fail(where + ": \"" + key() + "\" must be a string");
+		return value.get<std::string>();
+	}
+
+	int requireInt(const json& value, const std::string& where) {
+		if (!value.is_number_integer()) fail(where + ": \"" + key() + "\" must be an integer");
+		return value.get<int>();
+	}
+
+	// Drop weights: any non-negative number, 0 keeps an entry in the data but out of the tables
+	double requireWeight(const json& value, const std::string& where) {
+		if (!value.is_number() || value.get<double>() < 0.0) fail(where + ": weight must be a number >= 0");
+		return value.get<double>();
+	}
+
+	// One member of a "stats" object
+	void addStat(const json& value, const std::string& where) {
+		StatType type;
+		if (!STAT_TYPE_NAMES.parse(key(), type)) fail(where + ": unknown stat '" + key() + "'");
+		if (!value.is_number()) fail(where + ": stat '" + key() + "' is not a number");
+		pack.stat_table.push_back(PackStat{static_cast<uint32_t>(type), 0, value.get<double>()});
+	}
+
+	uint32_t statCount(uint32_t first) const { return static_cast<uint32_t>(pack.stat_table.size()) - first; }
+
+	PackBuilder& pack;
+};
+
+// items.json: an array of item objects. Items keep their file order, the starter gear is picked by index.
+class ItemsReader : public PackReader {
+public:
+	explicit ItemsReader(PackBuilder& pack) : PackReader("items.json", pack) {}
+
+protected:
+	void onBeginObject() override {
+		if (depth() == 1) fail(containerOffset(), "expected an array of items");
+		if (depth() == 2) {
+			item = PackItem{};
+			item.first_stat = static_cast<uint32_t>(pack.stat_table.size());
+			item.min_floor = 1;
+			item.drop_weight = 1.0;
+			item_offset = containerOffset();
+			id.clear();
+			name.clear();
+			description.clear();
+			slot_name.clear();
+			seen = 0;
+		}
+	}
+
+	void onBeginArray() override {
+		if (depth() == 3 && keyAt(2) == "stats") fail(where() + ": \"stats\" must be an object");
+	}
+
+	void onValue(const json& value) override {
+		if (depth() <= 1) fail(depth() == 0 ? "expected an array of items" : "entry " + std::to_string(index()) + " is not an object");
+		if (depth() == 2) {
+			field(value);
+		} else if (depth() == 3 && keyAt(2) == "stats") {
+			addStat(value, where());
+		}
+	}
+
+	void onEndObject() override {
+		if (depth() == 2) finishItem();
+	}
+
+private:
+	enum Field { ID = 1, NAME = 2, DESCRIPTION = 4, SLOT = 8 };
+
+	std::string where() const {
+		return "entry " + std::to_string(indexAt(1)) + ((seen & ID) ? " ('" + id + "')" : "");
+	}
+
+	void field(const json& value) {
+		const std::string& member = key();
+		if (member == "id") {
+			id = requireString(value, where());
+			id_offset = keyOffset();
+			seen |= ID;
+		} else if (member == "name") {
+			name = requireString(value, where());
+			seen |= NAME;
+		} else if (member == "description") {
+			description = requireString(value, where());
+			seen |= DESCRIPTION;
+		} else if (member == "slot") {
+			slot_name = requireString(value, where());
+			slot_offset = keyOffset();
+			seen |= SLOT;
+		} else if (member == "required_tech") {
+			item.required_tech = requireInt(value, where());
+		} else if (member == "min_floor") {
+			item.min_floor = requireInt(value, where());
+			if (item.min_floor < 1) fail(where() + ": min_floor must be at least 1");
+		} else if (member == "drop_weight") {
+			item.drop_weight = requireWeight(value, where() + " drop_weight");
+		} else if (member == "stats") {
+			fail(where() + ": \"stats\" must be an object");
+		}
+	}
+
+	void finishItem() {
+		const std::pair<Field, const char*> required[] = {{ID, "id"}, {NAME, "name"}, {DESCRIPTION, "description"}, {SLOT, "slot"}};
+		for (const auto& [flag, field_name] : required) {
+			if (!(seen & flag)) fail(item_offset, where() + ": missing string field \"" + field_name + "\"");
+		}
+		auto [it, inserted] = pack.item_ids.emplace(id, static_cast<uint32_t>(pack.items.size()));
+		if (!inserted) fail(id_offset, where() + ": duplicate id, first used by entry " + std::to_string(it->second));
+
+		EquipmentSlot slot = stringToEquipmentSlot(slot_name);
+		if (slot == EquipmentSlot::NONE) fail(slot_offset, where() + ": unknown slot '" + slot_name + "'");
+
+		item.id = pack.str(id);
+		item.name = pack.str(name);
+		item.description = pack.str(description);
+		item.slot = static_cast<uint32_t>(slot);
+		item.stat_count = statCount(item.first_stat);
+		pack.items.push_back(item);
+	}
+
+	PackItem item{};
+	size_t item_offset = 0, id_offset = 0, slot_offset = 0;
+	std::string id, name, description, slot_name;
+	unsigned seen = 0;
+};
+
+// bosses.json: an object keyed by floor number. Drops name items from items.json, they are
+// resolved once both files are read (see resolveDrops) so the two can be read at the same time.
+class BossesReader : public PackReader {
+public:
+	explicit BossesReader(PackBuilder& pack) : PackReader("bosses.json", pack) {}
+
+	// Points each drop at its item's index, `item_ids` is the items.json part's
+	void resolveDrops(const std::unordered_map<std::string, uint32_t>& item_ids) {
+		for (size_t i = 0; i < pending_drops.size(); i++) {
+			const PendingDrop& drop = pending_drops[i];
+			auto item_it = item_ids.find(drop.item_id);
+			if (item_it == item_ids.end()) fail(drop.offset, "floor " + std::to_string(drop.floor) + ": drops unknown item '" + drop.item_id + "'");
+			pack.boss_drops[i].item = item_it->second;
+		}
+	}
+
+	// The pack lists bosses by floor, whatever order the file uses
+	void sortByFloor() {
+		std::sort(pack.bosses.begin(), pack.bosses.end(), [](const PackBoss& a, const PackBoss& b) { return a.floor < b.floor; });
+	}
+
+protected:
+	void onBeginObject() override {
+		if (depth() == 2) beginBoss();
+	}
+
+	void onBeginArray() override {
+		if (depth() == 1) fail(containerOffset(), "expected an object keyed by floor");
+		if (depth() == 2) fail("floor " + keyAt(1) + " is not an object");
+		if (depth() == 3 && (keyAt(2) == "stats" || keyAt(2) == "drops")) wrongContainer(keyAt(2));
+	}
+
+	void onValue(const json& value) override {
+		if (depth() == 0) fail("expected an object keyed by floor");
+		if (depth() == 1) fail("floor " + key() + " is not an object");
+		if (depth() == 2) {
+			if (key() == "name") {
+				name = requireString(value, where());
+				has_name = true;
+			} else if (key() == "exp_reward") {
+				boss.exp_reward = requireInt(value, where());
+				has_exp_reward = true;
+			} else if (key() == "stats" || key() == "drops") {
+				wrongContainer(key());
+			}
+		} else if (depth() == 3 && keyAt(2) == "stats") {
+			addStat(value, where());
+		} else if (depth() == 3 && keyAt(2) == "drops") {
+			pack.boss_drops.push_back(PackDrop{0, 0, requireWeight(value, where() + " drop '" + key() + "'")});
+			pending_drops.push_back(PendingDrop{key(), keyOffset(), boss.floor});
+		}
+	}
+
+	void onEndObject() override {
+		if (depth() == 2) finishBoss();
+	}
+
+private:
+	std::string where() const { return "floor " + std::to_string(boss.floor); }
+
+	void wrongContainer(const std::string& field) {
+		fail(where() + (field == "stats" ? ": \"stats\" must be an object" : ": \"drops\" must be an object of item id -> weight"));
+	}
+
+	void beginBoss() {
+		const std::string& floor_str = keyAt(1);
+		size_t parsed = 0;
+		int floor = 0;
+		try {
+			floor = std::stoi(floor_str, &parsed);
+		} catch (const std::exception&) {
+			parsed = 0;
+		}
+		if (parsed != floor_str.size() || floor < 1) fail("'" + floor_str + "' is not a floor number");
+		if (!floors.insert(floor).second) fail(where() + ": listed twice");
+
+		boss = PackBoss{};
+		boss.floor = floor;
+		boss.first_stat = static_cast<uint32_t>(pack.stat_table.size());
+		boss.first_drop = static_cast<uint32_t>(pack.boss_drops.size());
+		boss_offset = containerOffset();
+		name.clear();
+		has_name = has_exp_reward = false;
+	}
+
+	void finishBoss() {
+		if (!has_name) fail(boss_offset, where() + ": missing string field \"name\"");
+		if (!has_exp_reward) fail(boss_offset, where() + ": missing integer field \"exp_reward\"");
+		boss.name = pack.str(name);
+		boss.stat_count = statCount(boss.first_stat);
+		boss.drop_count = static_cast<uint32_t>(pack.boss_drops.size()) - boss.first_drop;
+		pack.bosses.push_back(boss);
+	}
+
+	struct PendingDrop {
+		std::string item_id;
+		size_t offset;
+		int floor;
+	};
+
+	PackBoss boss{};
+	size_t boss_offset = 0;
+	std::string name;
+	bool has_name = false, has_exp_reward = false;
+	std::set<int> floors;
+	std::vector<PendingDrop> pending_drops; // Same order as pack.boss_drops
+};
+
+// levels.json: {"levels": {"<class>": [{"level": n, "experience_needed": n}, ...]}}
+class LevelsReader : public PackReader {
+public:
+	explicit LevelsReader(PackBuilder& pack) : PackReader("levels.json", pack) {}
+
+	void finish() {
+		if (!has_levels) fail(0, "expected a \"levels\" object keyed by class");
+	}
+
+	// Every curve has to belong to a class, `class_ids` is the classes.json part's
+	void checkClasses(const std::unordered_map<std::string, uint32_t>& class_ids) {
+		for (const auto& [class_id, curve_index] : pack.curve_ids) {
+			if (class_ids.count(class_id) == 0) fail(curve_offsets[curve_index], "class '" + class_id + "' is not in classes.json");
+		}
+	}
+
+protected:
+	void onBeginObject() override {
+		if (depth() == 2 && keyAt(1) == "levels") has_levels = true;
+		if (!inLevels()) return;
+		if (depth() == 3) fail(where() + ": expected an array of levels");
+		if (depth() == 4) {
+			level_offset = containerOffset();
+			has_level = has_needed = false;
+		}
+	}
+
+	void onBeginArray() override {
+		if (depth() == 1) fail(containerOffset(), "expected an object with a \"levels\" object keyed by class");
+		if (depth() == 2 && keyAt(1) == "levels") fail("expected a \"levels\" object keyed by class");
+		if (depth() == 3 && inLevels()) {
+			if (!pack.curve_ids.emplace(keyAt(2), static_cast<uint32_t>(curve_offsets.size())).second) fail(where() + ": listed twice");
+			curve_offsets.push_back(containerOffset());
+			curve.clear();
+		}
+	}
+
+	void onValue(const json& value) override {
+		if (depth() == 0) fail("expected an object with a \"levels\" object keyed by class");
+		if (depth() == 1 && key() == "levels") fail("expected a \"levels\" object keyed by class");
+		if (!inLevels()) return;
+		if (depth() == 2) fail(where() + ": expected an array of levels");
+		if (depth() == 3) fail(where() + ": level " + std::to_string(index()) + " is not an object");
+		if (depth() == 4 && key() == "level") {
+			level = requireInt(value, where());
+			has_level = true;
+		} else if (depth() == 4 && key() == "experience_needed") {
+			needed = requireInt(value, where());
+			has_needed = true;
+		}
+	}
+
+	void onEndObject() override {
+		if (depth() != 4 || !inLevels()) return;
+		if (!has_level) fail(level_offset, where() + ": missing integer field \"level\"");
+		if (!has_needed) fail(level_offset, where() + ": missing integer field \"experience_needed\"");
+		if (!curve.emplace(level, std::make_pair(needed, level_offset)).second) fail(level_offset, where() + ": level " + std::to_string(level) + " is listed twice");
+	}
+
+	void onEndArray() override {
+		if (depth() != 3 || !inLevels()) return;
+		// The game keeps a curve as a sorted array indexed by level (see LevelCurve.h)
+		int expected_level = 0;
+		int previous_needed = 0;
+		for (const auto& [each_level, entry] : curve) {
+			const auto& [each_needed, offset] = entry;
+			if (each_level != expected_level) fail(offset, where() + ": level " + std::to_string(expected_level) + " is missing, levels must run 0, 1, 2, ...");
+			if (each_needed < previous_needed) fail(offset, where() + ": level " + std::to_string(each_level) + " needs less experience than level " + std::to_string(each_level - 1));
+			expected_level++;
+			previous_needed = each_needed;
+		}
+
+		PackLevelCurve level_curve{};
+		level_curve.class_id = pack.str(keyAt(2));
+		level_curve.first_level = static_cast<uint32_t>(pack.levels.size());
+		level_curve.level_count = static_cast<uint32_t>(curve.size());
+		for (const auto& [each_level, entry] : curve) {
+			pack.levels.push_back(PackLevel{each_level, entry.first});
+		}
+		pack.level_curves.push_back(level_curve);
+	}
+
+private:
+	bool inLevels() const { return depth() >= 2 && keyAt(1) == "levels"; }
+	std::string where() const { return "class '" + keyAt(2) + "'"; }
+
+	std::map<int, std::pair<int, size_t>> curve; // Level -> experience needed and where it was listed, sorted for the pack
+	std::vector<size_t> curve_offsets; // Where each curve starts, by curve index
+	size_t level_offset = 0;
+	int level = 0, needed = 0;
+	bool has_levels = false, has_level = false, has_needed = false;
+};
+
+// loot.json: {"rarity_weights": [{"min_floor": n, "weights": {"<RARITY>": weight}}, ...]}
+class LootReader : public PackReader {
+public:
+	explicit LootReader(PackBuilder& pack) : PackReader("loot.json", pack) {}
+
+	// Tiers go into the pack sorted by the floor they start on
+	void finish() {
+		if (!has_tiers) fail(0, "expected a \"rarity_weights\" array of floor tiers");
+		if (tiers.empty() || tiers.begin()->first != 1) fail(0, "the first rarity tier must start at min_floor 1");
+		for (const auto& [min_floor, tier] : tiers) {
+			pack.rarity_tiers.push_back(tier);
+		}
+	}
+
+protected:
+	void onBeginArray() override {
+		if (depth() == 1) fail(containerOffset(), "expected an object with a \"rarity_weights\" array");
+		if (depth() == 2 && keyAt(1) == "rarity_weights") has_tiers = true;
+		if (inTiers() && depth() == 3) fail(where() + ": expected a tier object");
+		if (inTiers() && depth() == 4 && keyAt(3) == "weights") fail(where() + ": \"weights\" must be an object");
+	}
+
+	void onBeginObject() override {
+		if (depth() == 2 && keyAt(1) == "rarity_weights") fail("expected a \"rarity_weights\" array of floor tiers");
+		if (!inTiers()) return;
+		if (depth() == 3) {
+			tier = PackRarityTier{};
+			tier_offset = containerOffset();
+			has_min_floor = has_weights = false;
+			total = 0.0;
+		} else if (depth() == 4 && keyAt(3) == "weights") {
+			has_weights = true;
+		}
+	}
+
+	void onValue(const json& value) override {
+		if (depth() == 0) fail("expected an object with a \"rarity_weights\" array");
+		if (depth() == 1 && key() == "rarity_weights") fail("expected a \"rarity_weights\" array of floor tiers");
+		if (!inTiers()) return;
+		if (depth() == 2) fail("tier " + std::to_string(index()) + " is not an object");
+		if (depth() == 3 && key() == "min_floor") {
+			tier.min_floor = requireInt(value, where());
+			has_min_floor = true;
+		} else if (depth() == 3 && key() == "weights") {
+			fail(where() + ": \"weights\" must be an object");
+		} else if (depth() == 4 && keyAt(3) == "weights") {
+			Rarity rarity;
+			if (!RARITY_NAMES.parse(key(), rarity)) fail(where() + ": unknown rarity '" + key() + "'");
+			tier.weights[static_cast<int>(rarity)] = requireWeight(value, where() + " " + key());
+			total += tier.weights[static_cast<int>(rarity)];
+		}
+	}
+
+	void onEndObject() override {
+		if (depth() != 3 || !inTiers()) return;
+		if (!has_min_floor) fail(tier_offset, where() + ": missing integer field \"min_floor\"");
+		if (!has_weights) fail(tier_offset, where() + ": missing \"weights\" object");
+		if (total <= 0.0) fail(tier_offset, where() + ": every weight is 0");
+		if (!tiers.emplace(tier.min_floor, tier).second) fail(tier_offset, where() + ": listed twice");
+	}
+
+private:
+	bool inTiers() const { return depth() >= 2 && keyAt(1) == "rarity_weights"; }
+	std::string where() const {
+		return "rarity tier " + std::to_string(indexAt(2)) + (has_min_floor ? " (min_floor " + std::to_string(tier.min_floor) + ")" : "");
+	}
+
+	std::map<int, PackRarityTier> tiers;
+	PackRarityTier tier{};
+	size_t tier_offset = 0;
+	double total = 0.0;
+	bool has_tiers = false, has_min_floor = false, has_weights = false;
+};
+
+// classes.json: an array of pilot class objects. A class's id in the game is its position in the file.
+class ClassesReader : public PackReader {
+public:
+	explicit ClassesReader(PackBuilder& pack) : PackReader("classes.json", pack) {}
+
+	// Points each class at its level curve, `curve_ids` is the levels.json part's
+	void linkLevelCurves(const std::unordered_map<std::string, uint32_t>& curve_ids) {
+		for (size_t i = 0; i < pack.classes.size(); i++) {
+			std::string class_id(pack.strings, pack.classes[i].id.offset, pack.classes[i].id.length);
+			auto curve_it = curve_ids.find(class_id);
+			if (curve_it == curve_ids.end()) fail(id_offsets[i], "class " + std::to_string(i) + " ('" + class_id + "'): no level curve in levels.json");
+			pack.classes[i].level_curve = curve_it->second;
+		}
+	}
+
+protected:
+	void onBeginObject() override {
+		if (depth() == 1) fail(containerOffset(), "expected an array of classes");
+		if (depth() == 2) {
+			pilot_class = PackClass{};
+			pilot_class.first_stat = static_cast<uint32_t>(pack.stat_table.size());
+			class_offset = containerOffset();
+			id.clear();
+			name.clear();
+			passive_id.clear();
+			passive_description.clear();
+			seen = 0;
+		}
+	}
+
+	void onBeginArray() override {
+		if (depth() == 3 && (keyAt(2) == "stats" || keyAt(2) == "passive")) wrongContainer(keyAt(2));
+	}
+
+	void onValue(const json& value) override {
+		if (depth() <= 1) fail(depth() == 0 ? "expected an array of classes" : "entry " + std::to_string(index()) + " is not an object");
+		if (depth() == 2) {
+			field(value);
+		} else if (depth() == 3 && keyAt(2) == "stats") {
+			addStat(value, where());
+		} else if (depth() == 3 && keyAt(2) == "passive") {
+			if (key() == "id") passive_id = requireString(value, where() + " passive");
+			else if (key() == "description") passive_description = requireString(value, where() + " passive");
+		}
+	}
+
+	void onEndObject() override {
+		if (depth() == 2) finishClass();
+	}
+
+private:
+	enum Field { ID = 1, NAME = 2 };
+
+	std::string where() const {
+		return "class " + std::to_string(indexAt(1)) + ((seen & ID) ? " ('" + id + "')" : "");
+	}
+
+	void wrongContainer(const std::string& field) {
+		fail(where() + ": \"" + field + "\" must be an object");
+	}
+
+	void field(const json& value) {
+		const std::string& member = key();
+		if (member == "id") {
+			id = requireString(value, where());
+			id_offset = keyOffset();
+			seen |= ID;
+		} else if (member == "name") {
+			name = requireString(value, where());
+			seen |= NAME;
+		} else if (member == "stats" || member == "passive") {
+			wrongContainer(member);
+		}
+	}
+
+	void finishClass() {
+		if (!(seen & ID)) fail(class_offset, where() + ": missing string field \"id\"");
+		if (!(seen & NAME)) fail(class_offset, where() + ": missing string field \"name\"");
+		auto [it, inserted] = pack.class_ids.emplace(id, static_cast<uint32_t>(pack.classes.size()));
+		if (!inserted) fail(id_offset, where() + ": duplicate id, first used by class " + std::to_string(it->second));
+
+		pilot_class.id = pack.str(id);
+		pilot_class.name = pack.str(name);
+		pilot_class.passive_id = pack.str(passive_id);
+		pilot_class.passive_description = pack.str(passive_description);
+		pilot_class.stat_count = statCount(pilot_class.first_stat);
+		pack.classes.push_back(pilot_class);
+		id_offsets.push_back(id_offset);
+	}
+
+	PackClass pilot_class{};
+	size_t class_offset = 0, id_offset = 0;
+	std::vector<size_t> id_offsets; // Where each class's id was listed, by class index
+	std::string id, name, passive_id, passive_description;
+	unsigned seen = 0;
+};
+
+template <typename T>
+void appendTable(std::string& out, PackTable& table, const std::vector<T>& records) {
+	out.resize((out.size() + PACK_ALIGNMENT - 1) / PACK_ALIGNMENT * PACK_ALIGNMENT, '\0');
+	table.offset = static_cast<uint32_t>(out.size());
+	table.count = static_cast<uint32_t>(records.size());
+	if (!records.empty()) out.append(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(T));
+}
+
+// Runs `reader` over `text` and notes how long it took
+DataSourceTiming readSource(JsonStreamReader& reader, std::string_view text) {
+	auto start = std::chrono::steady_clock::now();
+	reader.read(text);
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	return DataSourceTiming{reader.fileName(), text.size(), elapsed.count()};
+}
+
+} // namespace
+
+std::string compileDataPack(std::string_view items_text, std::string_view bosses_text, std::string_view levels_text, std::string_view loot_text,
+	std::string_view classes_text, std::vector<DataSourceTiming>* timings) {
+	// NOTE(MSR): The files don't depend on each other until the bosses' drops are matched to items,
+	// so each one is read into its own part on its own thread. The parts are merged in file order,
+	// the pack comes out byte for byte what reading them one after another would give.
+	PackBuilder items_part, bosses_part, levels_part, loot_part, classes_part;
+	ItemsReader items_reader(items_part);
+	BossesReader bosses_reader(bosses_part);
+	LevelsReader levels_reader(levels_part);
+	LootReader loot_reader(loot_part);
+	ClassesReader classes_reader(classes_part);
+
+	// Declared after the readers, so an exception still waits for every thread before they go away
+	std::future<DataSourceTiming> bosses_read = std::async(std::launch::async, [&]() { return readSource(bosses_reader, bosses_text); });
+	std::future<DataSourceTiming> levels_read = std::async(std::launch::async, [&]() { return readSource(levels_reader, levels_text); });
+	std::future<DataSourceTiming> loot_read;
+	if (!loot_text.empty()) {
+		loot_read = std::async(std::launch::async, [&]() { return readSource(loot_reader, loot_text); });
+	}
+	std::future<DataSourceTiming> classes_read = std::async(std::launch::async, [&]() { return readSource(classes_reader, classes_text); });
+	DataSourceTiming items_timing = readSource(items_reader, items_text); // Usually the biggest, read here instead of waiting
+
+	// Errors are reported in file order, whichever thread hit its own first
+	DataSourceTiming bosses_timing = bosses_read.get();
+	bosses_reader.resolveDrops(items_part.item_ids);
+	bosses_reader.sortByFloor();
+	DataSourceTiming levels_timing = levels_read.get();
+	levels_reader.finish();
+	DataSourceTiming loot_timing = loot_read.valid() ? loot_read.get() : DataSourceTiming{};
+	if (loot_text.empty()) {
+		PackRarityTier tier{};
+		tier.min_floor = 1;
+		std::copy(std::begin(DEFAULT_RARITY_WEIGHTS), std::end(DEFAULT_RARITY_WEIGHTS), tier.weights);
+		loot_part.rarity_tiers.push_back(tier);
+	} else {
+		loot_reader.finish();
+	}
+	DataSourceTiming classes_timing = classes_read.get();
+	levels_reader.checkClasses(classes_part.class_ids);
+	classes_reader.linkLevelCurves(levels_part.curve_ids);
+	if (timings) {
+		timings->insert(timings->end(), {items_timing, bosses_timing, levels_timing});
+		if (!loot_text.empty()) timings->push_back(loot_timing);
+		timings->push_back(classes_timing);
+	}
+
+	PackBuilder& pack = items_part; // Goes first anyway, no need to copy the biggest part
+	for (const PackBuilder* part : {&bosses_part, &levels_part, &loot_part, &classes_part}) {
+		pack.append(*part);
+	}
+
+	// Header first, checksum and size are patched in at the end
+	std::string out(sizeof(PackHeader), '\0');
+	PackHeader header{};
+	std::memcpy(header.magic, PACK_MAGIC, sizeof(PACK_MAGIC));
+	header.version = DATA_PACK_FORMAT_VERSION;
+	header.byte_order = PACK_BYTE_ORDER;
+
+	header.tables[PACK_STRINGS].offset = static_cast<uint32_t>(out.size());
+	header.tables[PACK_STRINGS].count = static_cast<uint32_t>(pack.strings.size());
+	out += pack.strings;
+	appendTable(out, header.tables[PACK_STATS], pack.stat_table);
+	appendTable(out, header.tables[PACK_ITEMS], pack.items);
+	appendTable(out, header.tables[PACK_BOSSES], pack.bosses);
+	appendTable(out, header.tables[PACK_LEVEL_CURVES], pack.level_curves);
+	appendTable(out, header.tables[PACK_LEVELS], pack.levels);
+	appendTable(out, header.tables[PACK_BOSS_DROPS], pack.boss_drops);
+	appendTable(out, header.tables[PACK_RARITY_TIERS], pack.rarity_tiers);
+	appendTable(out, header.tables[PACK_CLASSES], pack.classes);
+
+	header.file_size = static_cast<uint32_t>(out.size());
+	header.crc32 = checksum32(std::string_view(out).substr(sizeof(PackHeader)));
+	std::memcpy(&out[0], &header, sizeof(header));
+	return out;
+}
+
+DataPack DataPack::openFile(const std::string& path) {
+	MappedFile mapped;
+	if (!mapFile(path, mapped)) {
+		throw std::runtime_error("DataPack: failed to open " + path);
+	}
+	try {
+		return openBytes(mapped.contents, mapped.mapping);
+	} catch (const std::runtime_error& e) {
+		throw std::runtime_error(std::string(e.what()) + " (" + path + ")");
+	}
+}
+
+DataPack DataPack::openBytes(std::string_view bytes, std::shared_ptr<const void> storage) {
+	DataPack pack;
+	pack.storage = std::move(storage);
+	pack.bytes = bytes;
+	pack.validate();
+	return pack;
+}
+
+Stats DataPack::stats(uint32_t first, uint32_t count) const {
+	Stats result;
+	for (uint32_t i = first; i < first + count; i++) {
+		result[static_cast<StatType>(stat_table[i].type)] = stat_table[i].value;
+	}
+	return result;
+}
+
+void DataPack::validate() {
+	auto fail = [](const std::string& what) { throw std::runtime_error("DataPack: " + what); };
+
+	if (bytes.size() < sizeof(PackHeader) || std::memcmp(bytes.data(), PACK_MAGIC, sizeof(PACK_MAGIC)) != 0) fail("not a data pack");
+	if (reinterpret_cast<uintptr_t>(bytes.data()) % PACK_ALIGNMENT != 0) fail("pack is not 8-byte aligned in memory");
+	header = reinterpret_cast<const PackHeader*>(bytes.data());
+	if (header->byte_order != PACK_BYTE_ORDER) fail("pack was written on a machine with the other byte order");
+	if (header->version != DATA_PACK_FORMAT_VERSION) fail("format " + std::to_string(header->version) + ", this build reads " + std::to_string(DATA_PACK_FORMAT_VERSION) + ", recompile the pack");
+	if (header->file_size != bytes.size()) fail("pack is truncated");
+	if (checksum32(bytes.substr(sizeof(PackHeader))) != header->crc32) fail("checksum mismatch");
+
+	auto table = [&](DataPackTable index, size_t record_size) -> const char* {
+		const PackTable& t = header->tables[index];
+		if (t.offset % PACK_ALIGNMENT != 0 && record_size > 1) fail("misaligned table " + std::to_string(index));
+		if (t.offset < sizeof(PackHeader) || t.offset > bytes.size() || uint64_t(t.count) * record_size > bytes.size() - t.offset) {
+			fail("table " + std::to_string(index) + " is out of bounds");
+		}
+		return bytes.data() + t.offset;
+	};
+	strings = table(PACK_STRINGS, 1);
+	stat_table = reinterpret_cast<const PackStat*>(table(PACK_STATS, sizeof(PackStat)));
+	items = reinterpret_cast<const PackItem*>(table(PACK_ITEMS, sizeof(PackItem)));
+	bosses = reinterpret_cast<const PackBoss*>(table(PACK_BOSSES, sizeof(PackBoss)));
+	level_curves = reinterpret_cast<const PackLevelCurve*>(table(PACK_LEVEL_CURVES, sizeof(PackLevelCurve)));
+	levels = reinterpret_cast<const PackLevel*>(table(PACK_LEVELS, sizeof(PackLevel)));
+	boss_drops = reinterpret_cast<const PackDrop*>(table(PACK_BOSS_DROPS, sizeof(PackDrop)));
+	rarity_tiers = reinterpret_cast<const PackRarityTier*>(table(PACK_RARITY_TIERS, sizeof(PackRarityTier)));
+	classes = reinterpret_cast<const PackClass*>(table(PACK_CLASSES, sizeof(PackClass)));
+
+	// Every reference checked once here, so the accessors never need to
+	const uint64_t string_bytes = header->tables[PACK_STRINGS].count;
+	const uint64_t stat_count = header->tables[PACK_STATS].count;
+	auto check_string = [&](const PackString& s) {
+		if (uint64_t(s.offset) + s.length > string_bytes) fail("string reference out of bounds");
+	};
+	auto check_stats = [&](uint32_t first, uint32_t count) {
+		if (uint64_t(first) + count > stat_count) fail("stat reference out of bounds");
+		for (uint32_t i = first; i < first + count; i++) {
+			if (stat_table[i].type > static_cast<uint32_t>(LAST_STAT_TYPE)) fail("unknown stat type " + std::to_string(stat_table[i].type));
+		}
+	};
+	for (size_t i = 0; i < itemCount(); i++) {
+		check_string(items[i].id);
+		check_string(items[i].name);
+		check_string(items[i].description);
+		check_stats(items[i].first_stat, items[i].stat_count);
+		if (items[i].slot > static_cast<uint32_t>(LAST_EQUIPMENT_SLOT)) fail("unknown slot " + std::to_string(items[i].slot));
+	}
+	for (size_t i = 0; i < bossCount(); i++) {
+		check_string(bosses[i].name);
+		if (i > 0 && bosses[i].floor <= bosses[i - 1].floor) fail("bosses are not sorted by floor");
+		check_stats(bosses[i].first_stat, bosses[i].stat_count);
+		if (uint64_t(bosses[i].first_drop) + bosses[i].drop_count > header->tables[PACK_BOSS_DROPS].count) fail("boss drop reference out of bounds");
+		for (uint32_t d = bosses[i].first_drop; d < bosses[i].first_drop + bosses[i].drop_count; d++) {
+			if (boss_drops[d].item >= itemCount()) fail("boss drop references a missing item");
+		}
+	}
+	if (rarityTierCount() == 0 || rarity_tiers[0].min_floor != 1) fail("the first rarity tier must start at floor 1");
+	for (size_t i = 1; i < rarityTierCount(); i++) {
+		if (rarity_tiers[i].min_floor <= rarity_tiers[i - 1].min_floor) fail("rarity tiers are not sorted by floor");
+	}
+	for (size_t i = 0; i < levelCurveCount(); i++) {
+		check_string(level_curves[i].class_id);
+		if (uint64_t(level_curves[i].first_level) + level_curves[i].level_count > header->tables[PACK_LEVELS].count) fail("level reference out of bounds");
+		const PackLevel* curve = levelsOf(level_curves[i]);
+		for (uint32_t n = 0; n < level_curves[i].level_count; n++) {
+			if (curve[n].level != static_cast<int32_t>(n)) fail("level curves must list levels 0, 1, 2, ... in order");
+			if (n > 0 && curve[n].experience_needed < curve[n - 1].experience_needed) fail("level curve experience decreases");
+		}
+	}
+	for (size_t i = 0; i < classCount(); i++) {
+		check_string(classes[i].id);
+		check_string(classes[i].name);
+		check_string(classes[i].passive_id);
+		check_string(classes[i].passive_description);
+		check_stats(classes[i].first_stat, classes[i].stat_count);
+		if (classes[i].level_curve >= levelCurveCount()) fail("class references a missing level curve");
+	}
+}
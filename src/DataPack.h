@@ -0,0 +1,176 @@
+#ifndef DATAPACK_H
+#define DATAPACK_H
+
+#include <string>
+#include <string_view>
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+#include "Stats.h"
+
+/* Compiled game-data pack
+	items.json, bosses.json, levels.json, loot.json and classes.json stay the authoring format. `idle_mech_datac`
+	(tools/) validates them once at build time and writes `data/game_data.pack`, which the server
+	maps and reads in place: no JSON parsing and no per-field allocation until templates are built
+	from it.
+
+	File layout, little-endian, every table 8-byte aligned:
+		header   PackHeader
+		tables   strings | stats | items | bosses | level curves | levels | boss drops | rarity tiers | classes
+
+	Records refer to strings by (offset, length) into the string table and to stats/levels by
+	(first, count) into their tables. DataPack::open checks every such reference once, after that
+	the accessors are plain pointer arithmetic.
+
+	When the server is started from JSON it compiles the same pack in memory, so both paths share
+	the validation and the loading code.
+*/
+
+#define DATA_PACK_FORMAT_VERSION 3 // v2: drop weights, min floors, boss drops and rarity tiers (see LootTable.h), v3: pilot classes
+#define DATA_PACK_DEFAULT_PATH "data/game_data.pack"
+
+enum DataPackTable : uint32_t {
+	PACK_STRINGS, PACK_STATS, PACK_ITEMS, PACK_BOSSES, PACK_LEVEL_CURVES, PACK_LEVELS,
+	PACK_BOSS_DROPS, PACK_RARITY_TIERS, PACK_CLASSES,
+	PACK_TABLE_COUNT
+};
+
+struct PackTable {
+	uint32_t offset; // From the start of the file
+	uint32_t count;  // Records (bytes for the string table)
+};
+
+struct PackHeader {
+	char magic[4]; // "IMDP"
+	uint16_t version;
+	uint16_t byte_order; // 0x0102 as written by the compiler, anything else is a foreign-endian pack
+	uint32_t file_size;
+	uint32_t crc32; // Of everything after the header
+	PackTable tables[PACK_TABLE_COUNT];
+};
+
+struct PackString {
+	uint32_t offset;
+	uint32_t length;
+};
+
+struct PackStat {
+	uint32_t type; // StatType value
+	uint32_t reserved;
+	double value;
+};
+
+struct PackItem {
+	PackString id;
+	PackString name;
+	PackString description;
+	uint32_t slot; // EquipmentSlot value
+	int32_t required_tech;
+	uint32_t first_stat;
+	uint32_t stat_count;
+	int32_t min_floor; // First floor it can drop on
+	uint32_t reserved;
+	double drop_weight;
+};
+
+struct PackBoss {
+	int32_t floor;
+	int32_t exp_reward;
+	PackString name;
+	uint32_t first_stat;
+	uint32_t stat_count;
+	uint32_t first_drop;
+	uint32_t drop_count; // 0 = the boss drops from the floor's table
+};
+
+struct PackDrop {
+	uint32_t item; // Index into the item table
+	uint32_t reserved;
+	double weight;
+};
+
+struct PackRarityTier {
+	int32_t min_floor;
+	uint32_t reserved;
+	double weights[4]; // Indexed by Rarity
+};
+
+struct PackLevelCurve {
+	PackString class_id;
+	uint32_t first_level;
+	uint32_t level_count;
+};
+
+struct PackLevel {
+	int32_t level;
+	int32_t experience_needed;
+};
+
+struct PackClass {
+	PackString id;
+	PackString name;
+	PackString passive_id;
+	PackString passive_description;
+	uint32_t first_stat;
+	uint32_t stat_count;
+	uint32_t level_curve; // Index into the level curve table, every class has one
+	uint32_t reserved;
+};
+
+class DataPack {
+public:
+	// Maps a pack file. Throws std::runtime_error if it is missing, corrupt or from another format version.
+	static DataPack openFile(const std::string& path);
+	// Uses bytes already in memory (an embedded or freshly compiled pack), `storage` keeps them alive
+	static DataPack openBytes(std::string_view bytes, std::shared_ptr<const void> storage);
+
+	size_t itemCount() const { return header->tables[PACK_ITEMS].count; }
+	size_t bossCount() const { return header->tables[PACK_BOSSES].count; }
+	size_t levelCurveCount() const { return header->tables[PACK_LEVEL_CURVES].count; }
+	size_t rarityTierCount() const { return header->tables[PACK_RARITY_TIERS].count; }
+	size_t classCount() const { return header->tables[PACK_CLASSES].count; }
+
+	const PackItem& item(size_t index) const { return items[index]; }
+	const PackBoss& boss(size_t index) const { return bosses[index]; } // Sorted by floor
+	const PackLevelCurve& levelCurve(size_t index) const { return level_curves[index]; } // Levels 0, 1, 2, ... with non-decreasing experience
+	const PackRarityTier& rarityTier(size_t index) const { return rarity_tiers[index]; } // Sorted by min_floor, the first is floor 1
+	const PackClass& pilotClass(size_t index) const { return classes[index]; } // classes.json order, the index is the class's id
+
+	std::string_view str(const PackString& s) const { return std::string_view(strings + s.offset, s.length); }
+	Stats stats(uint32_t first, uint32_t count) const;
+	const PackLevel* levelsOf(const PackLevelCurve& curve) const { return levels + curve.first_level; }
+	const PackDrop* dropsOf(const PackBoss& boss) const { return boss_drops + boss.first_drop; }
+
+private:
+	void validate(); // Bounds-checks every table and reference, throws std::runtime_error
+
+	std::shared_ptr<const void> storage;
+	std::string_view bytes;
+	const PackHeader* header = nullptr;
+	const char* strings = nullptr;
+	const PackStat* stat_table = nullptr;
+	const PackItem* items = nullptr;
+	const PackBoss* bosses = nullptr;
+	const PackLevelCurve* level_curves = nullptr;
+	const PackLevel* levels = nullptr;
+	const PackDrop* boss_drops = nullptr;
+	const PackRarityTier* rarity_tiers = nullptr;
+	const PackClass* classes = nullptr;
+};
+
+// How long compileDataPack spent on one source file
+struct DataSourceTiming {
+	std::string file;
+	size_t bytes = 0;
+	double milliseconds = 0.0;
+};
+
+// Validates the JSON files and builds a pack from them. The files are streamed (see JsonStream.h),
+// records go straight into the pack without a json DOM in between. Throws std::runtime_error with
+// the file, line, column and entry at fault (unknown stat or slot, duplicate item id, missing field, ...).
+// An empty `loot_json` stands for the built-in rarity odds. `timings`, if given, gets one entry per file parsed.
+std::string compileDataPack(std::string_view items_json, std::string_view bosses_json, std::string_view levels_json, std::string_view loot_json,
+	std::string_view classes_json, std::vector<DataSourceTiming>* timings = nullptr);
+
+#endif // DATAPACK_H
@@ -0,0 +1,98 @@
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+
+#include <poll.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+#include <sys/eventfd.h>
+
+#include "DataWatcher.h"
+
+DataWatcher::~DataWatcher() {
+	stop();
+}
+
+bool DataWatcher::start(const std::string& dir, std::vector<std::string> names, std::function<void()> callback) {
+	if (thread.joinable()) return true;
+
+	inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (inotify_fd < 0) {
+		std::cerr << "DataWatcher: inotify unavailable: " << std::strerror(errno) << std::endl;
+		return false;
+	}
+	// Directory watch, not file watches: a save through rename replaces the file's inode
+	if (inotify_add_watch(inotify_fd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+		std::cerr << "DataWatcher: can't watch " << dir << ": " << std::strerror(errno) << std::endl;
+		close(inotify_fd);
+		inotify_fd = -1;
+		return false;
+	}
+	stop_fd = eventfd(0, EFD_CLOEXEC);
+	if (stop_fd < 0) {
+		std::cerr << "DataWatcher: eventfd failed: " << std::strerror(errno) << std::endl;
+		close(inotify_fd);
+		inotify_fd = -1;
+		return false;
+	}
+
+	directory = dir;
+	file_names = std::move(names);
+	on_change = std::move(callback);
+	thread = std::thread(&DataWatcher::run, this);
+	std::cout << "DataWatcher: watching " << directory << " for changes." << std::endl;
+	return true;
+}
+
+void DataWatcher::stop() {
+	if (thread.joinable()) {
+		uint64_t one = 1;
+		if (write(stop_fd, &one, sizeof(one)) < 0) {
+			std::cerr << "DataWatcher: failed to signal stop: " << std::strerror(errno) << std::endl;
+		}
+		thread.join();
+	}
+	if (inotify_fd >= 0) close(inotify_fd);
+	if (stop_fd >= 0) close(stop_fd);
+	inotify_fd = -1;
+	stop_fd = -1;
+}
+
+void DataWatcher::run() {
+	alignas(struct inotify_event) char buffer[4096];
+	bool pending = false;
+
+	while (true) {
+		pollfd fds[2] = {{inotify_fd, POLLIN, 0}, {stop_fd, POLLIN, 0}};
+		// Block until something happens, or wait out the debounce once a change is pending
+		int ready = poll(fds, 2, pending ? DATA_RELOAD_DEBOUNCE_MS : -1);
+		if (ready < 0) {
+			if (errno == EINTR) continue;
+			std::cerr << "DataWatcher: poll failed: " << std::strerror(errno) << std::endl;
+			return;
+		}
+		if (fds[1].revents & POLLIN) return;
+
+		if (ready == 0) { // Quiet for the whole debounce window
+			pending = false;
+			try {
+				on_change();
+			} catch (const std::exception& e) {
+				std::cerr << "DataWatcher: reload failed, keeping the current data: " << e.what() << std::endl;
+			}
+			continue;
+		}
+
+		ssize_t length;
+		while ((length = read(inotify_fd, buffer, sizeof(buffer))) > 0) {
+			for (char* p = buffer; p < buffer + length; ) {
+				const inotify_event* event = reinterpret_cast<const inotify_event*>(p);
+				if (event->len > 0 && std::find(file_names.begin(), file_names.end(), std::string(event->name)) != file_names.end()) {
+					pending = true;
+				}
+				p += sizeof(inotify_event) + event->len;
+			}
+		}
+	}
+}
@@ -0,0 +1,41 @@
+#ifndef DATAWATCHER_H
+#define DATAWATCHER_H
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <thread>
+
+/* Hot reload of data/
+	Watches a directory with inotify and calls back on its own thread once a burst of writes to
+	one of the watched files has settled for DATA_RELOAD_DEBOUNCE_MS (editors often write a file in
+	several steps, or save through a temporary file and a rename).
+
+	The callback does the whole reload there: parse, validate, build a new GameData and publish it
+	with an atomic swap (see Game::loadDataPack). The game loop never waits on any of it. A reload
+	that throws is logged and the current data stays live.
+*/
+
+#define DATA_RELOAD_DEBOUNCE_MS 200
+
+class DataWatcher {
+public:
+	~DataWatcher();
+
+	// Starts watching `directory` for changes to `file_names`. Returns false if inotify is unavailable
+	// or the directory can't be watched (e.g. data/ is embedded in the binary and absent on disk).
+	bool start(const std::string& directory, std::vector<std::string> file_names, std::function<void()> on_change);
+	void stop(); // Joins the watcher thread, a reload in progress finishes first
+
+private:
+	void run();
+
+	std::string directory;
+	std::vector<std::string> file_names;
+	std::function<void()> on_change;
+	int inotify_fd = -1;
+	int stop_fd = -1; // eventfd that wakes the thread for stop()
+	std::thread thread;
+};
+
+#endif // DATAWATCHER_H
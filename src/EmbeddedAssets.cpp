@@ -0,0 +1,34 @@
+#include "EmbeddedAssets.h"
+
+#ifdef IDLE_MECH_EMBED_ASSETS
+// Defined in the generated EmbeddedAssetsData.cpp
+extern const EmbeddedAsset embedded_assets[];
+extern const size_t embedded_asset_count;
+#else
+static const EmbeddedAsset* const embedded_assets = nullptr;
+static const size_t embedded_asset_count = 0;
+#endif
+
+bool hasEmbeddedAssets() {
+	return embedded_asset_count > 0;
+}
+
+bool findEmbeddedAsset(const std::string& path, std::string_view& contents) {
+	for (size_t i = 0; i < embedded_asset_count; i++) {
+		if (path == embedded_assets[i].path) {
+			contents = std::string_view(reinterpret_cast<const char*>(embedded_assets[i].data), embedded_assets[i].size);
+			return true;
+		}
+	}
+	return false;
+}
+
+std::vector<const EmbeddedAsset*> listEmbeddedAssets(const std::string& prefix) {
+	std::vector<const EmbeddedAsset*> found;
+	for (size_t i = 0; i < embedded_asset_count; i++) {
+		if (std::string_view(embedded_assets[i].path).compare(0, prefix.size(), prefix) == 0) {
+			found.push_back(&embedded_assets[i]);
+		}
+	}
+	return found;
+}
@@ -0,0 +1,32 @@
+#ifndef EMBEDDEDASSETS_H
+#define EMBEDDEDASSETS_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+
+/* Assets compiled into the binary
+	With the IDLE_MECH_EMBED_ASSETS CMake option, everything under data/ and web/ is converted
+	into byte arrays at build time (cmake/EmbedAssets.cmake) and linked in, so the server never
+	reads them from disk. Without the option the table is empty and every lookup misses, which
+	makes callers fall back to reading files relative to the working directory.
+
+	Paths are relative to the project root using '/', e.g. "data/items.json" or "web/style.css".
+*/
+
+struct EmbeddedAsset {
+	const char* path;
+	const unsigned char* data;
+	size_t size;
+};
+
+bool hasEmbeddedAssets();
+
+// Looks up an embedded file. The view points into read-only memory valid for the whole program.
+bool findEmbeddedAsset(const std::string& path, std::string_view& contents);
+
+// All embedded files whose path starts with `prefix`
+std::vector<const EmbeddedAsset*> listEmbeddedAssets(const std::string& prefix);
+
+#endif // EMBEDDEDASSETS_H
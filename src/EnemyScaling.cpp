@@ -0,0 +1,53 @@
+#include <cmath>
+#include <algorithm>
+
+#include "EnemyScaling.h"
+#include "StringInterner.h"
+
+EnemyScalingTable::EnemyScalingTable(int enemies_per_floor) : enemies_per_floor(std::max(1, enemies_per_floor)) {}
+
+const EnemySpawnBlock& EnemyScalingTable::getGrunt(int floor, int wave_index) {
+	floor = std::max(1, floor);
+	wave_index = std::max(0, wave_index);
+	extendTo(floor);
+
+	std::vector<EnemySpawnBlock>& row = grunt_rows[floor - 1];
+	// NOTE(MSR): Waves past enemies_per_floor should not happen, but grow the row instead of reading out of bounds.
+	while (static_cast<int>(row.size()) <= wave_index) {
+		row.push_back(buildGrunt(floor, static_cast<int>(row.size())));
+	}
+	return row[wave_index];
+}
+
+// Builds every floor up to and including `floor`
+void EnemyScalingTable::extendTo(int floor) {
+	while (static_cast<int>(grunt_rows.size()) < floor) {
+		int next_floor = static_cast<int>(grunt_rows.size()) + 1;
+
+		std::vector<EnemySpawnBlock> row;
+		row.reserve(enemies_per_floor);
+		for (int wave = 0; wave < enemies_per_floor; wave++) {
+			row.push_back(buildGrunt(next_floor, wave));
+		}
+		grunt_rows.push_back(std::move(row));
+	}
+}
+
+EnemySpawnBlock EnemyScalingTable::buildGrunt(int floor, int wave_index) {
+	EnemySpawnBlock block;
+
+	double base_hp = 50.0 * pow(1.2, floor-1) * pow(1.05, wave_index);
+	double base_attack = 10.0 * pow(1.15, floor-1) * pow(1.03, wave_index);
+	double base_armor = 1 * pow(1.1, floor-1);
+	double base_shield = 20.0 * pow(1.1, floor-1);
+
+	block.stats[StatType::HEALTH]		 = base_hp;
+	block.stats[StatType::ATTACK]		 = base_attack;
+	block.stats[StatType::ARMOR]		 = std::max(1.0, base_armor); // always have atleast 1 armor
+	block.stats[StatType::ENERGY_SHIELD] = base_shield;
+	block.stats[StatType::MOBILITY]		 = 5.0 + floor;
+	block.stats[StatType::ATTACK_SPEED]  = 0.5 + (floor * 0.05);
+
+	block.name = internName("Grunt Mech Mk." + std::to_string(floor) + "-" + std::to_string(wave_index + 1));
+	return block;
+}
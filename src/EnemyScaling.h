@@ -0,0 +1,38 @@
+#ifndef ENEMYSCALING_H
+#define ENEMYSCALING_H
+
+#include <string_view>
+#include <vector>
+
+#include "Stats.h"
+
+// A fully prepared enemy ready to be copied onto `current_enemy`
+struct EnemySpawnBlock {
+	std::string_view name; // Interned, see StringInterner.h
+	Stats stats;
+};
+
+/* Precomputed enemy stat blocks
+	Every (floor, wave index) pair always produces the same grunt, so the pow() scaling,
+	the Stats map and the display name are built once and spawning becomes a table copy.
+
+	Rows are built lazily, one floor at a time, the first time a floor is requested.
+	Wave index is the number of enemies already defeated on that floor (0 based).
+*/
+class EnemyScalingTable {
+public:
+	explicit EnemyScalingTable(int enemies_per_floor);
+
+	const EnemySpawnBlock& getGrunt(int floor, int wave_index);
+
+	int getBuiltFloorCount() const { return static_cast<int>(grunt_rows.size()); }
+
+private:
+	void extendTo(int floor);
+	static EnemySpawnBlock buildGrunt(int floor, int wave_index);
+
+	int enemies_per_floor;
+	std::vector<std::vector<EnemySpawnBlock>> grunt_rows; // [floor - 1][wave_index]
+};
+
+#endif // ENEMYSCALING_H
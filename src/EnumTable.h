@@ -0,0 +1,94 @@
+#ifndef ENUMTABLE_H
+#define ENUMTABLE_H
+
+#include <array>
+#include <string_view>
+#include <cstdint>
+#include <cstddef>
+
+/* Enum <-> name tables
+	Each enum lists its values once in an X-macro (see Stats.h), which expands to both the enum and
+	its table of names. Both directions are then fixed-size lookups that never allocate:
+
+		name(value)         indexes the table and returns a std::string_view into it
+		parse(text, value)  hashes `text` into a bucket that holds at most one name, one compare decides
+
+	The hash is perfect: the seed is searched for at compile time until every name lands in its own
+	bucket, so a new enum value that would collide just makes the compiler pick another seed. Enums
+	must run 0, 1, 2, ... in the order the names are listed.
+*/
+
+#define ENUM_TABLE_VALUE(name) name,
+#define ENUM_TABLE_NAME(name) #name,
+
+template <typename Enum, size_t Count>
+class EnumTable {
+public:
+	static_assert(Count > 0 && Count < 255, "a bucket stores the value + 1 in a byte");
+
+	// Twice as many buckets as names keeps the seed search short
+	static constexpr size_t BUCKET_COUNT = []() {
+		size_t buckets = 1;
+		while (buckets < 2 * Count) buckets *= 2;
+		return buckets;
+	}();
+
+	constexpr explicit EnumTable(const std::array<std::string_view, Count>& names) : names(names), seed(findSeed(names)), buckets() {
+		for (size_t i = 0; i < Count; i++) {
+			buckets[bucketOf(names[i], seed)] = static_cast<uint8_t>(i + 1);
+		}
+	}
+
+	constexpr size_t size() const { return Count; }
+
+	// `fallback` for a value outside the enum (read from a newer save, say)
+	constexpr std::string_view name(Enum value, std::string_view fallback = "UNKNOWN") const {
+		size_t index = static_cast<size_t>(value);
+		return index < Count ? names[index] : fallback;
+	}
+
+	// False, leaving `value` alone, if `text` names no value
+	constexpr bool parse(std::string_view text, Enum& value) const {
+		uint8_t slot = buckets[bucketOf(text, seed)];
+		if (slot == 0 || names[slot - 1] != text) return false;
+		value = static_cast<Enum>(slot - 1);
+		return true;
+	}
+
+private:
+	// FNV-1a with the seed mixed into the offset basis
+	static constexpr size_t bucketOf(std::string_view text, uint32_t seed) {
+		uint32_t hash = 2166136261u ^ seed;
+		for (char c : text) {
+			hash = (hash ^ static_cast<uint8_t>(c)) * 16777619u;
+		}
+		return (hash ^ (hash >> 16)) & (BUCKET_COUNT - 1);
+	}
+
+	static constexpr uint32_t findSeed(const std::array<std::string_view, Count>& names) {
+		for (uint32_t seed = 0;; seed++) {
+			std::array<bool, BUCKET_COUNT> used{};
+			bool collided = false;
+			for (size_t i = 0; i < Count && !collided; i++) {
+				size_t bucket = bucketOf(names[i], seed);
+				collided = used[bucket];
+				used[bucket] = true;
+			}
+			if (!collided) return seed;
+		}
+	}
+
+	std::array<std::string_view, Count> names;
+	uint32_t seed;
+	std::array<uint8_t, BUCKET_COUNT> buckets; // Value + 1, 0 = empty
+};
+
+// Deduces the table size from the X-macro's name list
+template <typename Enum, size_t Count>
+constexpr EnumTable<Enum, Count> makeEnumTable(const std::string_view (&names)[Count]) {
+	std::array<std::string_view, Count> list{};
+	for (size_t i = 0; i < Count; i++) list[i] = names[i];
+	return EnumTable<Enum, Count>(list);
+}
+
+#endif // ENUMTABLE_H
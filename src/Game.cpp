@@ -1,53 +1,14 @@
 #include <iostream>
-#include <fstream> // For file/json loading
+#include <iterator>
 #include <algorithm>
+#include <filesystem>
 #include <stdexcept> // For std::runtime_error
 
 #include "Game.h"
 #include "GameClasses.h"
-
-// Helper for JSON to Enum conversion
-StatType stringToStatType(const std::string& s) {
-	if (s == "HEALTH") return StatType::HEALTH;
-	if (s == "ARMOR") return StatType::ARMOR;
-	if (s == "ENERGY_SHIELD") return StatType::ENERGY_SHIELD;
-	if (s == "ATTACK") return StatType::ATTACK;
-	if (s == "ATTACK_SPEED") return StatType::ATTACK_SPEED;
-	if (s == "MOBILITY") return StatType::MOBILITY;
-	if (s == "ENERGY") return StatType::ENERGY;
-	if (s == "ENERGY_RECOVERY") return StatType::ENERGY_RECOVERY;
-	if (s == "REPAIR") return StatType::REPAIR;
-	if (s == "TECHNOLOGY") return StatType::TECHNOLOGY;
-	
-	// Should never get here but incase it does; will throw and error
-	throw std::runtime_error("Unknown StatType stirng: " + s);
-}
-
-EquipmentSlot stringToEquipmentSlot(const std::string& s) {
-	if (s == "HEAD") return EquipmentSlot::HEAD;
-	if (s == "CHEST") return EquipmentSlot::CHEST;
-	if (s == "ARMS") return EquipmentSlot::ARMS;
-	if (s == "LEGS") return EquipmentSlot::LEGS;
-	if (s == "GENERATOR") return EquipmentSlot::GENERATOR;
-	if (s == "LEFT_ARM_WEAPON") return EquipmentSlot::LEFT_ARM_WEAPON;
-	if (s == "RIGHT_ARM_WEAPON") return EquipmentSlot::RIGHT_ARM_WEAPON;
-	if (s == "LEFT_SHOULDER_WEAPON") return EquipmentSlot::LEFT_SHOULDER_WEAPON;
-	if (s == "RIGHT_SHOULDER_WEAPON") return EquipmentSlot::RIGHT_SHOULDER_WEAPON;
-	return EquipmentSlot::NONE; // Default
-}
-
-std::string equipmentSlotToString(const EquipmentSlot& s) {
-	if (s == EquipmentSlot::HEAD) return "HEAD";
-	if (s == EquipmentSlot::CHEST) return "CHEST";
-	if (s == EquipmentSlot::ARMS) return "ARMS";
-	if (s == EquipmentSlot::LEGS) return "LEGS";
-	if (s == EquipmentSlot::GENERATOR) return "GENERATOR";
-	if (s == EquipmentSlot::LEFT_ARM_WEAPON) return "LEFT_ARM_WEAPON";
-	if (s == EquipmentSlot::RIGHT_ARM_WEAPON) return "RIGHT_ARM_WEAPON";
-	if (s == EquipmentSlot::LEFT_SHOULDER_WEAPON) return "LEFT_SHOULDER_WEAPON";
-	if (s == EquipmentSlot::RIGHT_SHOULDER_WEAPON) return "RIGHT_SHOULDER_WEAPON";
-	return "NONE";
-}
+#include "EmbeddedAssets.h"
+#include "MappedFile.h"
+#include "StringInterner.h"
 
 Game::Game() : current_floor(1), enemies_defeated_on_floor(0), combat_phase(CombatPhase::IDLE), game_running(false) {
 
@@ -76,114 +37,187 @@ Game::Game() : current_floor(1), enemies_defeated_on_floor(0), combat_phase(Comb
 	current_enemy = Mech("Test Enemy", test_enemy_stats);
 	std::cout << "`current_enemy` initialized with `test_enemy_stats`." << std::endl;
 
+	rng_seed = static_cast<unsigned int>(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+
 }
 
 Game::~Game() {
 	std::cout << "Game Object destructed!" << std::endl;
 }
 
-void Game::loadData(const std::string& item_file_path, const std::string& boss_file_path, const std::string& level_file_path) {
-	std::lock_guard<std::mutex> lock(game_state_mutex); // Protect data loading
+// Maps a data file, preferring the copy embedded in the binary (see EmbeddedAssets.h) over the filesystem
+static MappedFile mapDataFile(const std::string& path, const std::string& what) {
+	MappedFile mapped;
+	std::string_view embedded;
+	if (findEmbeddedAsset(path, embedded)) {
+		mapped.contents = embedded;
+		return mapped;
+	}
+	if (!mapFile(path, mapped)) {
+		throw std::runtime_error("Failed to open " + what + " file: " + path);
+	}
+	return mapped;
+}
+
+void Game::loadData(const std::string& item_file_path, const std::string& boss_file_path, const std::string& level_file_path, const std::string& loot_file_path,
+	const std::string& class_file_path) {
+	// NOTE(MSR): JSON is compiled into a pack in memory, so it gets exactly the validation and
+	// loading that a pack built by idle_mech_datac gets. The files are mapped and streamed, the only
+	// full copy of the data that ever exists is the pack itself.
+	MappedFile items = mapDataFile(item_file_path, "item");
+	MappedFile bosses = mapDataFile(boss_file_path, "boss");
+	MappedFile levels = mapDataFile(level_file_path, "level");
+	MappedFile loot = loot_file_path.empty() ? MappedFile() : mapDataFile(loot_file_path, "loot");
+	MappedFile classes = mapDataFile(class_file_path, "class");
+
+	std::vector<DataSourceTiming> timings;
+	auto compiled = std::make_shared<std::string>(compileDataPack(items.contents, bosses.contents, levels.contents, loot.contents, classes.contents, &timings));
+	for (const DataSourceTiming& timing : timings) {
+		std::cout << "Parsed " << timing.file << " (" << timing.bytes << " bytes) in " << timing.milliseconds << " ms" << std::endl;
+	}
+	loadDataPack(DataPack::openBytes(*compiled, compiled));
+}
+
+BossTable::BossTable(const DataPack& pack) : pack(pack), slots(std::make_unique<Slot[]>(pack.bossCount())) {}
+
+const BossData* BossTable::find(int floor) const {
+	if (!slots) return nullptr;
+	size_t low = 0, high = pack.bossCount();
+	while (low < high) { // Pack bosses are sorted by floor
+		size_t mid = (low + high) / 2;
+		if (pack.boss(mid).floor < floor) low = mid + 1;
+		else high = mid;
+	}
+	if (low == pack.bossCount() || pack.boss(low).floor != floor) return nullptr;
+
+	Slot& slot = slots[low];
+	std::call_once(slot.built, [&]() {
+		const PackBoss& entry = pack.boss(low);
+		slot.data.name = internName(pack.str(entry.name));
+		slot.data.stats = pack.stats(entry.first_stat, entry.stat_count);
+		slot.data.exp_reward = entry.exp_reward;
+	});
+	return &slot.data;
+}
+
+void Game::loadDataPack(const DataPack& pack) {
+	// Built off to the side and published in one swap, nothing here waits on the game lock
+	auto data = std::make_shared<GameData>();
 
 	// Load Items
-	std::ifstream item_fs(item_file_path);
-	if (!item_fs.is_open()) {
-		throw std::runtime_error("Failed to open item file: " + item_file_path);
-	}
-	json item_json_data;
-	try {
-		item_fs >> item_json_data; // Pipe in the item data
-	} catch (json::parse_error& e) {
-		throw std::runtime_error("Failed to parse item JSON: " + std::string(e.what()));
-	}
-
-	item_templates.clear();
-	for (const auto& item_entry : item_json_data) {
-		auto tpl = std::make_shared<ItemTemplate>();
-		tpl->id = item_entry.at("id").get<std::string>();
-		tpl->name = item_entry.at("name").get<std::string>();
-		tpl->description = item_entry.at("description").get<std::string>();
-		tpl->slot = stringToEquipmentSlot(item_entry.at("slot").get<std::string>());
-		tpl->required_tech = item_entry.value("required_tech", 0);
-
-		if (item_entry.contains("stats")) {
-			for (auto& [stat_key_str, stat_value] : item_entry.at("stats").items()) {
-				tpl->base_stats[stringToStatType(stat_key_str)] = stat_value.get<double>();
-			}
-		}
-		std::cout << "\n --- Item Template Added ---" << std::endl;
-		std::cout << "ID: " << tpl->id << std::endl;
-		std::cout << "NAME: " << tpl->name << std::endl;
-		std::cout << "DESCRIPTION: " << tpl->description << std::endl;
-		std::cout << "slot: " << equipmentSlotToString(tpl->slot) << std::endl;
-		std::cout << "required_tech: " << tpl->required_tech << std::endl;
-		item_templates.push_back(tpl);
-	}
-	std::cout << "Loaded " + std::to_string(item_templates.size()) + " item_templates." << std::endl;
-	//std::cout << "item_templates: " << item_json_data.dump(4);
-
-	// Load Bosses
-	std::ifstream boss_fs(boss_file_path);
-	if (!boss_fs.is_open()) {
-		throw std::runtime_error("Failed to open boss file: " + boss_file_path);	
-	}
-	json boss_json_data;
-	try {
-		boss_fs >> boss_json_data; // Pipe in the boss data
-	} catch (json::parse_error& e) {
-		throw std::runtime_error("Failed to parse boss JSON: " + std::string(e.what()));
-	}
-
-	boss_data.clear();
-	for (auto& [floor_str, boss_entry] : boss_json_data.items()) {
-		int floor_num = std::stoi(floor_str);
-		BossData bd;
-		bd.name = boss_entry.at("name").get<std::string>();
-		if (boss_entry.contains("stats")) {
-			for (auto& [stat_key_str, stat_value] : boss_entry.at("stats").items()) {
-				bd.stats[stringToStatType(stat_key_str)] = stat_value.get<double>();
-			}
+	data->item_templates.reserve(pack.itemCount());
+	for (size_t i = 0; i < pack.itemCount(); i++) {
+		const PackItem& entry = pack.item(i);
+		ItemTemplate tpl;
+		tpl.id = internName(pack.str(entry.id));
+		tpl.name = internName(pack.str(entry.name));
+		tpl.description = internName(pack.str(entry.description));
+		tpl.slot = static_cast<EquipmentSlot>(entry.slot);
+		tpl.required_tech = entry.required_tech;
+		tpl.base_stats = pack.stats(entry.first_stat, entry.stat_count);
+		data->item_templates.push_back(makeItemTemplate(std::move(tpl)));
+	}
+
+	// Bosses are built when their floor is first reached
+	data->bosses = BossTable(pack);
+
+	// Load classes in id order, each with its level curve (listed densely from level 0 in the pack)
+	for (size_t i = 0; i < pack.classCount(); i++) {
+		const PackClass& entry = pack.pilotClass(i);
+		PilotClass pilot_class;
+		pilot_class.key = pack.str(entry.id);
+		pilot_class.name = pack.str(entry.name);
+		pilot_class.stats = pack.stats(entry.first_stat, entry.stat_count);
+		pilot_class.passive.id = pack.str(entry.passive_id);
+		pilot_class.passive.description = pack.str(entry.passive_description);
+
+		const PackLevelCurve& curve = pack.levelCurve(entry.level_curve);
+		const PackLevel* levels = pack.levelsOf(curve);
+		std::vector<int> thresholds;
+		thresholds.reserve(curve.level_count);
+		for (uint32_t n = 0; n < curve.level_count; n++) {
+			thresholds.push_back(levels[n].experience_needed);
 		}
-		bd.exp_reward = boss_entry.at("exp_reward").get<int>();
-		boss_data[floor_num] = bd;
+		pilot_class.level_curve = LevelCurve(std::move(thresholds));
+		data->classes.add(std::move(pilot_class));
 	}
+	data->version = ++data_loads;
+
+	buildLootTables(pack, *data);
 
-	std::cout << "Loaded " + std::to_string(boss_data.size()) + " boss definitions." << std::endl;
-	//std::cout << "boss data: " << boss_json_data.dump(4);	
+	std::cout << "Loaded " << data->item_templates.size() << " item templates, " << data->bosses.size() << " boss definitions and " << data->classes.size() << " pilot classes." << std::endl;
+	// The old version is freed by whoever lets go of it last: usually here, or a tick that was still using it
+	std::atomic_store(&game_data, std::shared_ptr<const GameData>(std::move(data)));
+	state_version++;
+}
+
+void Game::buildLootTables(const DataPack& pack, GameData& data) {
+	LootTables& loot = data.loot;
 
-	// Load levels
-	std::ifstream level_fs(level_file_path);
-	if (!level_fs.is_open()) {
-		throw std::runtime_error("Failed to open level file: " + level_file_path);	
+	for (size_t i = 0; i < pack.rarityTierCount(); i++) {
+		const PackRarityTier& tier = pack.rarityTier(i);
+		LootTables::RarityTier rarity_tier;
+		rarity_tier.min_floor = tier.min_floor;
+		rarity_tier.rarity = AliasTable(std::vector<double>(std::begin(tier.weights), std::end(tier.weights)));
+		loot.rarity_tiers.push_back(std::move(rarity_tier));
 	}
-	json level_json_data;
-	try {
-		level_fs >> level_json_data; // Pipe in the boss data
-	} catch (json::parse_error& e) {
-		throw std::runtime_error("Failed to parse level JSON: " + std::string(e.what()));
+
+	// One band per distinct min_floor, each holding only the templates unlocked on that floor
+	std::map<int, std::vector<uint32_t>> band_templates;
+	for (uint32_t i = 0; i < pack.itemCount(); i++) {
+		band_templates[pack.item(i).min_floor].push_back(i);
 	}
-	for (auto& [classes, requirements] : level_json_data["levels"].items()) {
-		std::map<int, int> temp_map;
-		for (auto& each_level : requirements) {
-			std::cout << "each_level( " << classes << "): " << each_level << std::endl;
-			temp_map[each_level["level"]] = each_level["experience_needed"];
+
+	auto make_table = [&pack](const std::vector<uint32_t>& indices, double& total_weight) {
+		TemplateTable table;
+		std::vector<double> weights;
+		for (uint32_t index : indices) {
+			if (pack.item(index).drop_weight <= 0.0) continue;
+			table.template_indices.push_back(index);
+			weights.push_back(pack.item(index).drop_weight);
+			total_weight += pack.item(index).drop_weight;
 		}
-		level_requirements[classes] = temp_map;
-	}
-	std::cout << "Loaded " << "level data" << std::endl;
-	for (auto& [classes, requirements] : level_requirements) {
-		std::cout << classes << ": " << std::endl;
-		for (auto& [level, needed] : requirements) {
-			std::cout << level << ":" << needed << std::endl;
+		table.table = AliasTable(weights);
+		return table;
+	};
+	double cumulative_weight = 0.0;
+	std::array<double, TOTAL_NUMBER_OF_SLOTS> cumulative_slot_weight{};
+	for (const auto& [floor, indices] : band_templates) {
+		std::array<std::vector<uint32_t>, TOTAL_NUMBER_OF_SLOTS> indices_by_slot;
+		for (uint32_t i : indices) {
+			indices_by_slot[pack.item(i).slot].push_back(i);
 		}
+		LootTables::TemplateBand band;
+		band.min_floor = floor;
+		band.all = make_table(indices, cumulative_weight);
+		band.cumulative_weight = cumulative_weight;
+		for (size_t slot = 0; slot < TOTAL_NUMBER_OF_SLOTS; slot++) {
+			band.by_slot[slot] = make_table(indices_by_slot[slot], cumulative_slot_weight[slot]);
+			band.cumulative_slot_weight[slot] = cumulative_slot_weight[slot];
+		}
+		loot.template_bands.push_back(std::move(band));
 	}
 
-
+	for (size_t i = 0; i < pack.bossCount(); i++) {
+		const PackBoss& boss = pack.boss(i);
+		if (boss.drop_count == 0) continue;
+		TemplateTable table;
+		std::vector<double> weights;
+		const PackDrop* drops = pack.dropsOf(boss);
+		for (uint32_t d = 0; d < boss.drop_count; d++) {
+			if (drops[d].weight <= 0.0) continue;
+			table.template_indices.push_back(drops[d].item);
+			weights.push_back(drops[d].weight);
+		}
+		table.table = AliasTable(weights);
+		loot.boss_drops[boss.floor] = std::move(table);
+	}
 }
 
 bool Game::startGame() {
 	std::cerr << "DEBUG: Game::startGame() called." << std::endl;
 	std::lock_guard<std::mutex> lock(game_state_mutex); // Protect game_running state
+	state_version++;
 	
 	if (!class_selected) {
 		std::cerr << "Cannot start game: No class selected." << std::endl;
@@ -196,8 +230,10 @@ bool Game::startGame() {
 		// NOTE(MSR): It's important that game_loop itself doesn't re-spawn the first enemy
 		// if it's already set by a previous, stoppedgame. Or reset things here.
 		// For a fresh start:
-		current_floor = 1;
-		enemies_defeated_on_floor = 0;
+		if (!restored_from_save) {
+			current_floor = 1;
+			enemies_defeated_on_floor = 0;
+		}
 		combat_phase = CombatPhase::IDLE; // Reset Combat phase
 		game_log.clear();
 		std::cerr << "DEBUG: Game::StartGame() - Game state reset." << std::endl;
@@ -205,23 +241,36 @@ bool Game::startGame() {
 		// WARN(MSR): current_enemy might need to be cleared or reset if a fully fresh start is wanted
 		// THE CRITICAL PART: Thread creation
 		try {
-			game_thread = std::thread(&Game::gameLoop, this);
-			std::cerr << "DEBUG: Game::startGame() - game_thread object CREATED." << std::endl;
-
-			// Give starter gear to player
-			Equipment& player_mech_equipment = player_mech.getEquipment();
-			std::cout << "\nEquiping basic loadout onto player mech" << std::endl;
-			
+			if (!replay_mode) {
+				game_thread = std::thread(&Game::gameLoop, this);
+				std::cerr << "DEBUG: Game::startGame() - game_thread object CREATED." << std::endl;
+			}
 
-			// Starter equipment based on class picked.	
-			// TODO(MSR): if (player_pulot
-			auto common_laser_gun_item = std::make_shared<Item>(item_templates[0], Rarity::COMMON);
-			player_mech_equipment.equip(common_laser_gun_item);
-			player_mech_equipment.equip(std::make_shared<Item>(item_templates[2], Rarity::COMMON));
-			player_mech_equipment.equip(std::make_shared<Item>(item_templates[3], Rarity::COMMON));
+			// Starter gear rolls come from the session seed so they can be replayed
+			seedRandom(rng_seed);
+
+			// Give starter gear to player, a restored save already has its own
+			std::shared_ptr<const GameData> data = getGameData();
+			if (!restored_from_save && data->item_templates.size() < 4) {
+				std::cerr << "Not enough item templates for the starter loadout, starting without it." << std::endl;
+			} else if (!restored_from_save) {
+				Equipment& player_mech_equipment = player_mech.getEquipment();
+				std::cout << "\nEquiping basic loadout onto player mech" << std::endl;
+				
+
+				// Starter equipment based on class picked.	
+				// TODO(MSR): if (player_pulot
+				auto common_laser_gun_item = std::make_shared<Item>(data->item_templates[0], Rarity::COMMON);
+				player_mech_equipment.equip(common_laser_gun_item);
+				player_mech_equipment.equip(std::make_shared<Item>(data->item_templates[2], Rarity::COMMON));
+				player_mech_equipment.equip(std::make_shared<Item>(data->item_templates[3], Rarity::COMMON));
+			}
 
 			player_mech.printCurrentEquipment();
 
+			if (replay_mode) {
+				seedRandom(loopSeed()); // Stands in for the game thread seeding itself in gameLoop()
+			}
 
 		} catch (const std::system_error& e) {
 			std::cerr << "FATAL ERROR: Game::startGame() - std::system_error while creating thread: " << e.what() << " (Code: " << e.code() << ")" << std::endl;
@@ -237,7 +286,14 @@ bool Game::startGame() {
 			return false;
 		}
 
+		// The journal needs a snapshot to apply to, take one before the first event is flushed
+		compaction_requested = true;
+
 		// If thread creation didn't throw:
+		ReplayCommand command;
+		command.tick = tick_count;
+		command.type = ReplayCommandType::START_GAME;
+		recordCommand(command);
 		std::cerr << "DEBUG: Game::startGame() - Successfully started. Returning true." << std::endl;
 		return true;
 	} else {
@@ -248,10 +304,20 @@ bool Game::startGame() {
 }
 
 void Game::stopGameLoop() {
+	{
+		std::lock_guard<std::mutex> lock(game_state_mutex);
+		if (game_running) {
+			ReplayCommand command;
+			command.tick = tick_count;
+			command.type = ReplayCommandType::STOP;
+			recordCommand(command);
+		}
+	}
 	game_running = false;
 	if (game_thread.joinable()) {
 		game_thread.join();
 	}
+	state_version++;
 }
 
 bool Game::isGameRunning() const {
@@ -261,53 +327,95 @@ bool Game::isGameRunning() const {
 // TAG: MAIN GAME LOOP
 void Game::gameLoop() {
 	std::cerr<< "DEBUG: Game::gameLoop() THREAD STARTED." << std::endl;
-	auto last_time = std::chrono::high_resolution_clock::now();
+	seedRandom(loopSeed()); // Loot rolls on this thread are part of the recorded session
 	std::this_thread::sleep_for(std::chrono::milliseconds(INITIAL_GAMELOOP_DELAY_MS)); // Wait for main thread to start up then this.
-	while (game_running) {
-		auto current_time = std::chrono::high_resolution_clock::now();
-		std::chrono::duration<double> elapsed = current_time - last_time;
-		double delta_time = elapsed.count();
-		last_time = current_time;
-
-		gameTick(delta_time);
 
-		// Cap update rate slightly to prevent 100% CPU usage on one core if gameTick is too fast
-		std::this_thread::sleep_for(std::chrono::milliseconds(GAMELOOP_DELAY_MS)); // Approx 33 FPS for game logic
+	// NOTE(MSR): Game time advances by a fixed GAME_TICK_SECONDS per tick instead of the measured
+	// wall-clock delta, which is what makes sessions replayable. The loop is paced against the
+	// wall clock so the game still runs in real time.
+	const auto tick_interval = std::chrono::milliseconds(GAMELOOP_DELAY_MS);
+	auto next_tick = std::chrono::steady_clock::now();
+	while (game_running) {
+		gameTick(GAME_TICK_SECONDS);
+		persistIfDue();
+
+		// Approx 33 FPS for game logic
+		next_tick += tick_interval;
+		auto now = std::chrono::steady_clock::now();
+		if (next_tick <= now) {
+			next_tick = now + tick_interval; // Fell behind (e.g. the loot pause), don't try to catch up
+		}
+		std::this_thread::sleep_until(next_tick);
 	}
 	std::cerr << "DEBUG: Game::gameLoop() THREAD EXITED." << std::endl;
 }
 
 void Game::gameTick(double delta_time) {
 	std::lock_guard<std::mutex> lock(game_state_mutex);
+	state_version++; // Bumped under the lock, so whoever sees the new version also sees this tick's result
+	std::shared_ptr<const GameData> data = getGameData(); // The whole tick runs against this version, even if a reload lands meanwhile
+
+	// Observation changes how fights are resolved, so it is recorded like a command
+	bool observed = replay_mode ? replay_observed : isObserved();
+	if (observed != last_tick_observed) {
+		ReplayCommand command;
+		command.tick = tick_count;
+		command.type = ReplayCommandType::OBSERVED;
+		command.observed = observed;
+		recordCommand(command);
+		last_tick_observed = observed;
+	}
 
 	// player_mech.regenerate(delta_time); // Player always regenerates
 	if (combat_phase == CombatPhase::IDLE) {
-		startCombat();
+		startCombat(*data);
 	} else if (combat_phase == CombatPhase::ENEMY_DEFEATED) {
 		std::cout << "Enemy defeated..." << std::endl;
-		awardLoot();
+		awardLoot(*data);
 		enemies_defeated_on_floor++;
 	
 		int exp_gain = 0;
 		if (is_enemy_boss) {
 			current_floor++;
 			enemies_defeated_on_floor = 0;
-			exp_gain = boss_data[current_floor].exp_reward;
-			std::cout << "Boss defeated! Advancing to next floor " + std::to_string(current_floor) << std::endl;
+			exp_gain = bossForFloor(*data, current_floor).exp_reward;
+			std::cout << "Boss defeated! Advancing to next floor " << current_floor << std::endl;
 		} else {
 			exp_gain = current_floor * 2.0; // Simple exp scaling
 		}
 
 		std::cout << "exp_gain: " << exp_gain << std::endl;
 
-		player_mech.addExperience(exp_gain, level_requirements, player_pilot_class.id);
+		int level_before = player_mech.getLevel();
+		player_mech.addExperience(exp_gain, playerClass(*data).level_curve);
+
+		if (is_enemy_boss) {
+			JournalEvent floor_event;
+			floor_event.type = JournalEventType::FLOOR_ADVANCE;
+			floor_event.floor = current_floor;
+			floor_event.enemies_defeated_on_floor = enemies_defeated_on_floor;
+			journalEvent(floor_event);
+		}
+		JournalEvent kill_event;
+		kill_event.type = JournalEventType::KILL;
+		kill_event.enemies_defeated_on_floor = enemies_defeated_on_floor;
+		kill_event.experience = player_mech.getCurrentExperience();
+		journalEvent(kill_event);
+		if (player_mech.getLevel() != level_before) {
+			JournalEvent level_event;
+			level_event.type = JournalEventType::LEVEL_UP;
+			level_event.level = player_mech.getLevel();
+			journalEvent(level_event);
+		}
 
 		if (enemies_defeated_on_floor >= ENEMIES_PER_FLOOR) {
-			spawnBoss();
+			spawnBoss(*data);
 		} else {
 			spawnNextEnemy();
 		}
 		combat_phase = CombatPhase::IDLE; // Will trigger startCombat on next tick
+	} else if (!observed && resolveCombatFastForward()) {
+		// Nobody is watching, the whole fight was resolved in this tick
 	} else { // PLAYER_TURN, ENEMY_TURN, BETWEEN_TURNS
 		handleCombat(delta_time);
 	}
@@ -320,6 +428,8 @@ void Game::gameTick(double delta_time) {
 		player_mech.resetCombatState();
 		std::cout << "Player Mech has been repaired." << std::endl;
 	}
+
+	tick_count++;
 }
 
 /**
@@ -327,14 +437,14 @@ void Game::gameTick(double delta_time) {
 	2. Resets the player and current_enemy's combat state
 	3. Determines who goes first by using the StatType::MOBILITY stat
   **/
-void Game::startCombat() {
+void Game::startCombat(const GameData& data) {
 	std::cout << std::endl;
 	std::cout << " ----------------------------- " << std::endl;
 	std::cout << "Starting new combat encounter..." << std::endl;
 
 	if (!current_enemy.isAlive() || current_enemy.getName().empty()) { // If no ememy or previous one was defeated
 		if (enemies_defeated_on_floor >= ENEMIES_PER_FLOOR) {
-			spawnBoss();
+			spawnBoss(data);
 		} else {
 			spawnNextEnemy();
 		}
@@ -343,8 +453,8 @@ void Game::startCombat() {
 	player_mech.resetCombatState();
 	current_enemy.resetCombatState();
 	
-	std::cout << "Combat started against: " + current_enemy.getName() << std::endl;
-	std::cout << "Player HP: " + std::to_string(player_mech.getCurrentHp()) + " Player Energy Shield: " + std::to_string(player_mech.getCurrentEnergyShield()) + ", Enemy HP: " + std::to_string(current_enemy.getCurrentHp()) + " Enemy Energy Shield: " + std::to_string(current_enemy.getCurrentEnergyShield()) << std::endl;
+	std::cout << "Combat started against: " << current_enemy.getName() << std::endl;
+	std::cout << "Player HP: " << std::to_string(player_mech.getCurrentHp()) << " Player Energy Shield: " << std::to_string(player_mech.getCurrentEnergyShield()) << ", Enemy HP: " << std::to_string(current_enemy.getCurrentHp()) << " Enemy Energy Shield: " << std::to_string(current_enemy.getCurrentEnergyShield()) << std::endl;
 
 	// Determine who goes first
 	double player_mobility = getStat(player_mech.getTotalStats(), StatType::MOBILITY);
@@ -355,7 +465,7 @@ void Game::startCombat() {
 		std::cout << "Player takes the first turn." << std::endl;
 	} else {
 		combat_phase = CombatPhase::ENEMY_TURN;
-		std::cout << current_enemy.getName() + " takes the first turn." << std::endl;
+		std::cout << current_enemy.getName() << " takes the first turn." << std::endl;
 	}
 	time_since_last_action = 0.0;
 }
@@ -370,7 +480,7 @@ void Game::handleCombat(double delta_time) {
 	Mech* attacker = nullptr;
 	Mech* defender = nullptr;
 	CombatPhase next_phase_if_alive = CombatPhase::IDLE;
-	std::string attacker_name;
+	std::string_view attacker_name;
 
 	if (combat_phase == CombatPhase::PLAYER_TURN) {
 		attacker = &player_mech;
@@ -392,11 +502,12 @@ void Game::handleCombat(double delta_time) {
 
 	if (time_since_last_action >= required_delay) {
 		double damage = attacker->calculateAttackDamage();
-		std::cout << attacker_name + " attacks for " + std::to_string(damage).substr(0,4) + " damage." << std::endl;
+		std::string damage_text = std::to_string(damage); // Short enough to stay off the heap
+		std::cout << attacker_name << " attacks for " << std::string_view(damage_text).substr(0, 4) << " damage." << std::endl;
 		defender->takeDamage(damage); 
 
 		if (!defender->isAlive()) {
-			std::cout << defender->getName() + " has been defeated!" << std::endl;
+			std::cout << defender->getName() << " has been defeated!" << std::endl;
 			if (defender == &current_enemy) {
 				combat_phase = CombatPhase::ENEMY_DEFEATED;
 			} else { // Player was defeated
@@ -411,92 +522,144 @@ void Game::handleCombat(double delta_time) {
 	}
 }
 
+/**
+	Resolves the rest of the current fight analytically (see CombatResolver.h).
+	Leaves the game in the same state stepping `handleCombat` would have:
+		- ENEMY_DEFEATED with the player's remaining HP/Shield, or
+		- the player at 0 HP so gameTick's death check handles the revive.
+  **/
+bool Game::resolveCombatFastForward() {
+	bool player_first;
+	if (combat_phase == CombatPhase::PLAYER_TURN) {
+		player_first = true;
+	} else if (combat_phase == CombatPhase::ENEMY_TURN) {
+		player_first = false;
+	} else {
+		return false; // Not a turn phase
+	}
+
+	Stats p_total_stats = player_mech.getTotalStats();
+	Stats e_total_stats = current_enemy.getTotalStats();
+
+	CombatantState player_state;
+	player_state.hp = player_mech.getCurrentHp();
+	player_state.energy_shield = player_mech.getCurrentEnergyShield();
+	player_state.armor = getStat(p_total_stats, StatType::ARMOR);
+	player_state.attack = getStat(p_total_stats, StatType::ATTACK);
+
+	CombatantState enemy_state;
+	enemy_state.hp = current_enemy.getCurrentHp();
+	enemy_state.energy_shield = current_enemy.getCurrentEnergyShield();
+	enemy_state.armor = getStat(e_total_stats, StatType::ARMOR);
+	enemy_state.attack = getStat(e_total_stats, StatType::ATTACK);
+
+	FightResolution result = player_first ? resolveFight(player_state, enemy_state) : resolveFight(enemy_state, player_state);
+	if (!result.resolvable) {
+		return false;
+	}
+
+	const CombatantState& player_end = player_first ? result.first_attacker : result.second_attacker;
+	const CombatantState& enemy_end = player_first ? result.second_attacker : result.first_attacker;
+	bool player_won = (result.first_attacker_wins == player_first);
+
+	player_mech.setCombatState(player_end.hp, player_end.energy_shield);
+	current_enemy.setCombatState(enemy_end.hp, enemy_end.energy_shield);
+	time_since_last_action = 0.0;
+
+	std::cout << "Fast-forwarded fight against " << current_enemy.getName() << " (" << result.exchanges << " exchanges): " << (player_won ? "enemy defeated." : "player defeated.") << std::endl;
+	if (player_won) {
+		combat_phase = CombatPhase::ENEMY_DEFEATED;
+	}
+	return true;
+}
+
 void Game::spawnNextEnemy() {
-	std::cout << "Spawning next regular enemy for floor " + std::to_string(current_floor) + ", defeated: " + std::to_string(enemies_defeated_on_floor + 1) << std::endl;	
-
-	Stats enemy_stats;
-	double base_hp = 50.0 * pow(1.2, current_floor-1) * pow(1.05, enemies_defeated_on_floor);
-	double base_attack = 10.0 * pow(1.15, current_floor-1) * pow(1.03, enemies_defeated_on_floor);
-	double base_armor = 1 * pow(1.1, current_floor-1);
-	double base_shield = 20.0 * pow(1.1, current_floor-1);
-
-	enemy_stats[StatType::HEALTH]		 = base_hp;
-	enemy_stats[StatType::ATTACK]		 = base_attack;
-	enemy_stats[StatType::ARMOR]		 = std::max(1.0, base_armor); // always have atleast 1 armor
-	enemy_stats[StatType::ENERGY_SHIELD] = base_shield;
-	enemy_stats[StatType::MOBILITY]		 = 5.0 + current_floor;
-	enemy_stats[StatType::ATTACK_SPEED]  = 0.5 + (current_floor * 0.05);
-	
-	current_enemy.setName("Grunt Mech Mk." + std::to_string(current_floor) + "-" + std::to_string(enemies_defeated_on_floor + 1));
-	current_enemy.setBaseStats(enemy_stats);
+	std::cout << "Spawning next regular enemy for floor " << current_floor << ", defeated: " << enemies_defeated_on_floor + 1 << std::endl;
+
+	// Stats and name are precomputed per (floor, wave), see EnemyScalingTable
+	const EnemySpawnBlock& block = enemy_scaling.getGrunt(current_floor, enemies_defeated_on_floor);
+	current_enemy.setName(block.name);
+	current_enemy.setBaseStats(block.stats);
 	current_enemy.resetCombatState(); // NOTE(MSR): This is crucial to do for stats like HP/Shield
 	is_enemy_boss = false;
-	std::cout << "Spawned: " + current_enemy.getName() + " with HP " + std::to_string(current_enemy.getCurrentHp()) << std::endl;
+	std::cout << "Spawned: " << current_enemy.getName() << " with HP " << std::to_string(current_enemy.getCurrentHp()) << std::endl;
 }
 
-void Game::spawnBoss() {
-	std::cout << "Spawning BOSS for floor " + std::to_string(current_floor) << std::endl;
+void Game::spawnBoss(const GameData& data) {
+	std::cout << "Spawning BOSS for floor " << current_floor << std::endl;
 
-	auto boss_it = boss_data.find(current_floor);
-	if (boss_it != boss_data.end()) {
-		const BossData& bd = boss_it->second;
-		current_enemy.setName(bd.name);
-		current_enemy.setBaseStats(bd.stats);
-		current_enemy.resetCombatState();
-		is_enemy_boss = true;
-		std::cout << "Spawned BOSS: " + current_enemy.getName() << std::endl;
-	} else {
-		std::cout << "ERROR: No boss data found for floor " + std::to_string(current_floor) + ". Spawning a strong Grunt instead." << std::endl;
-		// Fallback: spawn a very strong regular enemy
-		Stats fallback_boss_stats;
-		double base_hp = 200.0 * pow(1.5, current_floor-1);
-		double base_attack = 50.0 * pow(1.4, current_floor-1);
-		fallback_boss_stats[StatType::HEALTH] = base_hp;
-		fallback_boss_stats[StatType::ATTACK] = base_attack;
-		fallback_boss_stats[StatType::ARMOR] = 1 * pow(1.2, current_floor-1);
-		fallback_boss_stats[StatType::ENERGY_SHIELD] = 100.0 * pow(1.3, current_floor-1);
-		fallback_boss_stats[StatType::MOBILITY] = 10.0 + current_floor * 2;
-		fallback_boss_stats[StatType::ATTACK_SPEED] = 0.8 + (current_floor * 0.1);
-
-		current_enemy.setName("Overcharged Grunt");
-		current_enemy.setBaseStats(fallback_boss_stats);
-		current_enemy.resetCombatState();
-		is_enemy_boss = true;
-	}
-}
-
-void Game::awardLoot() {
-	std::shared_ptr<Item> dropped_item = generateRandomItem();
+	const BossData& bd = bossForFloor(data, current_floor);
+	current_enemy.setName(bd.name);
+	current_enemy.setBaseStats(bd.stats);
+	current_enemy.resetCombatState();
+	is_enemy_boss = true;
+	std::cout << "Spawned BOSS: " << current_enemy.getName() << std::endl;
+}
+
+const PilotClass& Game::playerClass(const GameData& data) {
+	static const PilotClass no_class; // A class a reload removed, the player keeps going but never levels up
+	if (player_class_version != data.version) {
+		const PilotClass* pilot_class = data.classes.find(player_class_key);
+		player_class_id = pilot_class ? pilot_class->id : NO_PILOT_CLASS;
+		player_class_version = data.version;
+	}
+	return (player_class_id != NO_PILOT_CLASS) ? data.classes.get(player_class_id) : no_class;
+}
+
+const BossData& Game::bossForFloor(const GameData& data, int floor) {
+	if (const BossData* boss = data.bosses.find(floor)) {
+		return *boss;
+	}
+	return boss_generator.get(rng_seed, floor); // Past bosses.json, see BossGenerator.h
+}
+
+void Game::awardLoot(const GameData& data) {
+	std::shared_ptr<Item> dropped_item = rollItem(data, current_floor, is_enemy_boss);
 	if (dropped_item) {
-		std::cout << "Loot dropped: " + dropped_item->getName() + " (" + rarityToString(dropped_item->getRarity()) + ")" << std::endl;
+		std::cout << "Loot dropped: " << dropped_item->getName() << " (" << rarityToString(dropped_item->getRarity()) << ")" << std::endl;
+
+		JournalEvent loot_event;
+		loot_event.type = JournalEventType::LOOT;
+		loot_event.item.template_id = dropped_item->getId();
+		loot_event.item.rarity = dropped_item->getRarity();
+		loot_event.item.stats = dropped_item->getStats();
+		journalEvent(loot_event);
 		// For now, we don't auto-equip if its better or add to inventory just logging
 		// TODO(MSR): player_mech.addToInventory(dropped_item)
 	} else {
 		std::cout << "No loot dropped this time." << std::endl;
 	}
-	std::this_thread::sleep_for(std::chrono::milliseconds(AWARDLOOT_DELAY_MS)); // Adding small delay so that awarded loot is given time to be read.
+	if (!replay_mode) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(AWARDLOOT_DELAY_MS)); // Adding small delay so that awarded loot is given time to be read.
+	}
 }
 
 std::shared_ptr<Item> Game::generateRandomItem() {
-	if (item_templates.empty()) {
-		std::cout << "No item templates loaded, cannot generate loot." << std::endl;
-		return nullptr;
+	int floor;
+	{
+		std::lock_guard<std::mutex> lock(game_state_mutex);
+		floor = current_floor;
 	}
+	return rollItem(*getGameData(), floor, false);
+}
 
-	// Simple rarity roll
-	// 60% Common, 25% Uncommon, 10% Rare, 5% Legendary
-	double roll = myRandomDouble(0, 100); 
+std::shared_ptr<Item> Game::rollItem(const GameData& data, int floor, bool from_boss) {
+	// Rarity, then template, one draw each from the session's RNG (see LootTable.h)
 	Rarity chosen_rarity;
-	if (roll < 5) chosen_rarity = Rarity::LEGENDARY;
-	else if (roll < 15) chosen_rarity = Rarity::RARE;
-	else if (roll < 40) chosen_rarity = Rarity::UNCOMMON;
-	else chosen_rarity = Rarity::COMMON;
+	if (!data.loot.rollRarity(floor, myRandomDouble(0, 1), chosen_rarity)) {
+		std::cout << "No loot tables loaded, cannot generate loot." << std::endl;
+		return nullptr;
+	}
 
-	// Pick a random template
-	int template_index = static_cast<int>(myRandomDouble(0, item_templates.size() - 0.0001)); // -0.0001 to make it exclusive for size
-	std::shared_ptr<const ItemTemplate> chosen_template = item_templates[template_index];
+	uint32_t template_index;
+	double template_roll = myRandomDouble(0, 1);
+	bool found = (from_boss && data.loot.rollBossDrop(floor, template_roll, template_index)) || data.loot.rollTemplate(floor, template_roll, template_index);
+	if (!found) {
+		std::cout << "No item templates can drop on floor " << floor << ", cannot generate loot." << std::endl;
+		return nullptr;
+	}
 
-	auto new_item = std::make_shared<Item>(chosen_template, chosen_rarity);
+	auto new_item = std::make_shared<Item>(data.item_templates[template_index], chosen_rarity);
 	// Item constructor calls generateInstanceStats
 	return new_item;
 }
@@ -504,6 +667,7 @@ std::shared_ptr<Item> Game::generateRandomItem() {
 // -- Equip Logic --
 bool Game::playerEquipItem(int inventory_index) {
 	std::lock_guard<std::mutex> lock(game_state_mutex);
+	state_version++;
 
 	auto item_to_equip = player_mech.getItemFromInventory(inventory_index);
 	if (!item_to_equip) return false;
@@ -519,7 +683,20 @@ bool Game::playerEquipItem(int inventory_index) {
 		player_mech.addToInventory(old_item);
 	}
 
-	logEvent("Equipped " + item_to_equip->getName());
+	logEvent(std::string("Equipped ").append(item_to_equip->getName()));
+
+	JournalEvent equip_event;
+	equip_event.type = JournalEventType::EQUIP;
+	equip_event.inventory_index = inventory_index;
+	equip_event.slot = item_to_equip->getSlot();
+	equip_event.returned_old_item = (old_item != nullptr);
+	journalEvent(equip_event);
+
+	ReplayCommand command;
+	command.tick = tick_count;
+	command.type = ReplayCommandType::EQUIP;
+	command.index = inventory_index;
+	recordCommand(command);
 	return true;
 }
 
@@ -528,7 +705,18 @@ void Game::logEvent(const std::string& msg) {
 	if (game_log.size() > MAX_LOG_SIZE) game_log.erase(game_log.begin());
 }
 
+bool Game::isObserved() const {
+	long long now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	return (now_ms - last_observed_ms.load()) < OBSERVER_TIMEOUT_MS;
+}
+
+void Game::markObserved() {
+	last_observed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
 GameStateForWeb Game::getGameState() {
+	markObserved();
+
 	std::lock_guard<std::mutex> lock(game_state_mutex);
 	GameStateForWeb state;
 
@@ -568,35 +756,17 @@ GameStateForWeb Game::getGameState() {
 	state.player_experience = player_mech.getCurrentExperience();
 
 	// Calculate EXP needed for NEXT level
-	if (player_pilot_class.id == "ace") {
-		int current_level = player_mech.getLevel();
-		for (auto& [level, needed] : level_requirements["ace"]) {
-			if (level == current_level) {
-				state.player_next_level_experience = needed;
-			}
-		}
-	} else if (player_pilot_class.id == "bulwark") {
-		int current_level = player_mech.getLevel();
-		for (auto& [level, needed] : level_requirements["bulwark"]) {
-			if (level == current_level) {
-				state.player_next_level_experience = needed;
-			}
-		}
-
-	} else if (player_pilot_class.id == "technocrat") {
-		int current_level = player_mech.getLevel();
-		for (auto& [level, needed] : level_requirements["technocrat"]) {
-			if (level == current_level) {
-				state.player_next_level_experience = needed;
-			}
-		}
-
-	}
+	state.player_next_level_experience = playerClass(*getGameData()).level_curve.experienceToLeave(player_mech.getLevel());
 
 	state.player_total_stats = p_total_stats;
 	for (const auto& pair : player_mech.getEquipment().getEquippedItems()) {
 		if (pair.second) {
-			state.player_equipment_names[pair.first] = pair.second->getName() + " (" + rarityToString(pair.second->getRarity()) + ")";
+			// Formatted straight into the entry, no temporaries
+			std::string_view name = pair.second->getName();
+			std::string_view rarity = rarityToString(pair.second->getRarity());
+			std::string& label = state.player_equipment_names[pair.first];
+			label.reserve(name.size() + rarity.size() + 3);
+			label.append(name).append(" (").append(rarity).append(")");
 		} else {
 			state.player_equipment_names[pair.first] = "(Empty)";
 		}
@@ -680,24 +850,283 @@ void Game::print_enemy_mech_stats() {
 
 bool Game::initPlayerClass(const std::string& classId) {
 	std::lock_guard<std::mutex> lock(game_state_mutex);
+	state_version++;
 	
-	// 1. Use the factory to get class stats
-	player_pilot_class = PilotClassFactory::createPilotClass(classId);
-	if (player_pilot_class.id.empty() || player_pilot_class.archetype == ClassArchetype::None) {
+	// 1. Look the class up in classes.json
+	std::shared_ptr<const GameData> data = getGameData();
+	const PilotClass* pilot_class = data->classes.find(classId);
+	if (!pilot_class) {
 		return false; // Invalid class
 	}
-	
+
+	// From here on the class is its id, looked up by string again only when a reload replaces the data
+	player_class_key = pilot_class->key;
+	player_class_id = pilot_class->id;
+	player_class_version = data->version;
+
 	// 2. BUILDING THE MECH (At "System Initialization")
 	// Now create the mech with the class stats
-	player_mech = Mech("Player", player_pilot_class.stats);
+	player_mech = Mech("Player", pilot_class->stats);
+
+	class_selected = true;
+	std::cout << "Player initialized as: " << classId << std::endl;
+
+	ReplayCommand command;
+	command.tick = tick_count;
+	command.type = ReplayCommandType::SELECT_CLASS;
+	command.class_id = classId;
+	recordCommand(command);
+	return true;
+}
 
-	// Set the class ID on the mech for EXP lookup later
-	// TODO(MSR): need to add a setClassId method to mech class
-	// player_mech.setClassId(classId);
+// --- Recording/Replay ---
 
-	
+bool Game::enableRecording(const std::string& path) {
+	std::lock_guard<std::mutex> lock(game_state_mutex);
+	if (!recorder.open(path, rng_seed)) {
+		std::cerr << "Failed to open replay recording: " << path << std::endl;
+		return false;
+	}
+	std::cout << "Recording session (seed " << rng_seed << ") to " << path << std::endl;
+	return true;
+}
+
+// NOTE(MSR): Callers hold game_state_mutex
+void Game::recordCommand(const ReplayCommand& command) {
+	if (!replay_mode) {
+		recorder.record(command);
+	}
+}
+
+void Game::applyReplayCommand(const ReplayCommand& command) {
+	switch (command.type) {
+		case ReplayCommandType::SELECT_CLASS:
+			initPlayerClass(command.class_id);
+			break;
+		case ReplayCommandType::START_GAME:
+			startGame();
+			break;
+		case ReplayCommandType::EQUIP:
+			playerEquipItem(command.index);
+			break;
+		case ReplayCommandType::OBSERVED:
+			replay_observed = command.observed;
+			break;
+		case ReplayCommandType::STOP:
+			game_running = false;
+			break;
+	}
+}
+
+/**
+	Re-runs a recorded session on the calling thread.
+	Commands are applied once `tick_count` reaches the tick they were recorded at, then the game
+	ticks back to back with the fixed timestep and no loot pause, so hours of play take seconds.
+  **/
+void Game::runReplay(const ReplayLog& log, uint64_t until_tick) {
+	replay_mode = true;
+	rng_seed = log.seed;
+
+	size_t next_command = 0;
+	while (until_tick == 0 || tick_count < until_tick) {
+		while (next_command < log.commands.size() && log.commands[next_command].tick <= tick_count) {
+			const ReplayCommand& command = log.commands[next_command];
+			if (command.type == ReplayCommandType::STOP && next_command + 1 == log.commands.size()) {
+				return; // End of the session, leave it running so the final state can be inspected
+			}
+			applyReplayCommand(command);
+			next_command++;
+		}
+
+		bool recording_over = next_command >= log.commands.size();
+		if (!game_running) {
+			if (recording_over) break;
+			tick_count = log.commands[next_command].tick; // Nothing ticks while the loop is stopped
+			continue;
+		}
+		if (recording_over && until_tick == 0) {
+			break; // Recording ended without a stop (crash), nothing more is known
+		}
+
+		gameTick(GAME_TICK_SECONDS);
+	}
+}
+
+SaveSnapshot Game::captureSnapshot() {
+	return materialize(captureForSave());
+}
+
+Game::SaveCapture Game::captureForSave() {
+	std::lock_guard<std::mutex> lock(game_state_mutex);
+	SaveCapture capture;
+	SaveSnapshot& snapshot = capture.fields;
+
+	snapshot.pilot_class_id = class_selected ? player_class_key : "";
+	snapshot.rng_seed = rng_seed;
+	snapshot.tick_count = tick_count;
+	snapshot.journal_sequence = journal.lastSequence(); // Events are appended under this lock, so this matches the state copied here
+	snapshot.current_floor = current_floor;
+	snapshot.enemies_defeated_on_floor = enemies_defeated_on_floor;
+
+	snapshot.player_name = player_mech.getName();
+	snapshot.player_base_stats = player_mech.getBaseStats();
+	snapshot.player_level = player_mech.getLevel();
+	snapshot.player_experience = player_mech.getCurrentExperience();
+	for (const auto& [slot, item] : player_mech.getEquipment().getEquippedItems()) {
+		if (item) capture.equipment.emplace_back(slot, item);
+	}
+	const auto& inventory = player_mech.getInventory();
+	capture.inventory.reserve(inventory.size());
+	for (const auto& item : inventory) {
+		if (item) capture.inventory.push_back(item);
+	}
+	return capture;
+}
+
+SaveSnapshot Game::materialize(SaveCapture capture) {
+	auto save_item = [](const Item& item) {
+		SavedItem saved;
+		saved.template_id = item.getId();
+		saved.rarity = item.getRarity();
+		saved.stats = item.getStats();
+		return saved;
+	};
 
+	SaveSnapshot snapshot = std::move(capture.fields);
+	snapshot.equipment.reserve(capture.equipment.size());
+	for (const auto& [slot, item] : capture.equipment) {
+		snapshot.equipment.emplace_back(slot, save_item(*item));
+	}
+	snapshot.inventory.reserve(capture.inventory.size());
+	for (const auto& item : capture.inventory) {
+		snapshot.inventory.push_back(save_item(*item));
+	}
+	return snapshot;
+}
+
+bool Game::restoreSnapshot(const SaveSnapshot& snapshot) {
+	std::lock_guard<std::mutex> lock(game_state_mutex);
+	state_version++;
+
+	if (game_running) {
+		std::cerr << "Cannot restore a save while the game is running." << std::endl;
+		return false;
+	}
+	std::shared_ptr<const GameData> data = getGameData();
+	const PilotClass* pilot_class = data->classes.find(snapshot.pilot_class_id);
+	if (!pilot_class) {
+		std::cerr << "Save has unknown pilot class: '" << snapshot.pilot_class_id << "'" << std::endl;
+		return false;
+	}
+
+	std::unordered_map<std::string_view, std::shared_ptr<const ItemTemplate>> templates_by_id;
+	for (const auto& tpl : data->item_templates) {
+		templates_by_id[tpl->id] = tpl;
+	}
+	// Items whose template was removed from items.json since the save are dropped
+	auto restore_item = [&templates_by_id](const SavedItem& saved) -> std::shared_ptr<Item> {
+		auto it = templates_by_id.find(saved.template_id);
+		if (it == templates_by_id.end()) {
+			std::cerr << "Save references unknown item template '" << saved.template_id << "', dropping it." << std::endl;
+			return nullptr;
+		}
+		return std::make_shared<Item>(it->second, saved.rarity, saved.stats);
+	};
+
+	player_class_key = pilot_class->key;
+	player_class_id = pilot_class->id;
+	player_class_version = data->version;
+	player_mech = Mech(snapshot.player_name.empty() ? "Player" : snapshot.player_name, snapshot.player_base_stats);
+	player_mech.restoreProgress(snapshot.player_level, snapshot.player_experience);
+	for (const auto& [slot, saved] : snapshot.equipment) {
+		if (auto item = restore_item(saved)) {
+			player_mech.getEquipment().equip(item);
+		}
+	}
+	for (const SavedItem& saved : snapshot.inventory) {
+		if (auto item = restore_item(saved)) {
+			player_mech.addToInventory(item);
+		}
+	}
+	player_mech.resetCombatState(); // Saves don't carry mid-fight HP, the mech comes back repaired
+
+	// The session carries on: same seed, so the same generated bosses (see BossGenerator.h), and the tick count resumes
+	rng_seed = snapshot.rng_seed;
+	tick_count = snapshot.tick_count;
+
+	current_floor = std::max(1, snapshot.current_floor);
+	enemies_defeated_on_floor = std::max(0, snapshot.enemies_defeated_on_floor);
 	class_selected = true;
-	std::cout << "Player initialized as: " << classId << std::endl;
+	restored_from_save = true;
+
+	std::cout << "Restored save: " << pilot_class->key << " level " << snapshot.player_level << ", floor " << current_floor << ", " << snapshot.inventory.size() << " inventory items, seed " << rng_seed << std::endl;
 	return true;
 }
+
+void Game::journalEvent(const JournalEvent& event) {
+	if (journal.isOpen()) {
+		journal.append(event);
+	}
+}
+
+bool Game::enablePersistence(const std::string& path) {
+	std::string journal_path = path + ".journal";
+	SaveSnapshot snapshot;
+	bool resumed = recoverSave(path, journal_path, snapshot);
+	if (resumed && !restoreSnapshot(snapshot)) {
+		return false;
+	}
+	if (!resumed) {
+		std::filesystem::remove(journal_path); // Leftovers without a snapshot would reuse sequence numbers
+	}
+
+	save_path = path;
+	journal.open(journal_path, resumed ? snapshot.journal_sequence : 0);
+	save_worker.start();
+	if (resumed) {
+		compactSave(); // Fold the replayed tail into a fresh snapshot so the journal starts empty
+	}
+	return true;
+}
+
+void Game::compactSave() {
+	if (save_path.empty() || !isClassSelected()) return;
+
+	save_worker.waitIdle(); // A queued background save must not land after this one
+	SaveSnapshot snapshot = captureSnapshot();
+	writeSnapshotFile(save_path, encodeSnapshot(snapshot));
+	journal.compactThrough(snapshot.journal_sequence);
+	compaction_requested = false;
+}
+
+void Game::requestCompaction() {
+	if (!isClassSelected()) return;
+
+	compaction_requested = false;
+	compaction_in_flight = true;
+	auto capture = std::make_shared<SaveCapture>(captureForSave());
+
+	// Keyed by save file: a compaction still waiting in the queue is replaced by this newer one
+	save_worker.submit(save_path, [this, capture]() {
+		struct InFlightGuard {
+			std::atomic<bool>& flag;
+			~InFlightGuard() { flag = false; }
+		} guard{compaction_in_flight};
+
+		SaveSnapshot snapshot = materialize(std::move(*capture));
+		writeSnapshotFile(save_path, encodeSnapshot(snapshot));
+		journal.compactThrough(snapshot.journal_sequence);
+	});
+}
+
+void Game::persistIfDue() {
+	if (!journal.isOpen()) return;
+
+	// Only the capture happens here, encoding and every write/fsync run on `save_worker`
+	if (compaction_requested || (!compaction_in_flight && journal.eventsSinceCompaction() >= JOURNAL_COMPACT_EVENTS)) {
+		requestCompaction();
+	}
+	if (journal.isFlushDue()) {
+		save_worker.submit(save_path + ".journal", [this]() { journal.flush(); });
+	}
+}
@@ -8,11 +8,21 @@
 #include <thread>
 #include <atomic>
 #include <map>
+#include <chrono>
 
 #include "Mech.h"
 #include "Item.h"
 #include "Utils.h"
 #include "GameClasses.h"
+#include "EnemyScaling.h"
+#include "BossGenerator.h"
+#include "CombatResolver.h"
+#include "Replay.h"
+#include "SaveGame.h"
+#include "Journal.h"
+#include "SaveWorker.h"
+#include "DataPack.h"
+#include "LootTable.h"
 #include "json.hpp" // nlohmann/json
 
 /* Implementation Highlights
@@ -33,13 +43,42 @@
 #define INITIAL_GAMELOOP_DELAY_MS 3000 // Used to delay the game loop from starting.
 #define GAMELOOP_DELAY_MS 30 // Used to cap update rate slightly to prevent 100% CPU usage on one core.
 #define AWARDLOOT_DELAY_MS 2000 // Used to add a delay so that awarded loot is given time to be read.
+#define GAME_TICK_SECONDS (GAMELOOP_DELAY_MS / 1000.0) // Fixed simulation timestep, every tick advances game time by exactly this much.
+#define OBSERVER_TIMEOUT_MS 5000 // A session with no /api/gamestate poll for this long is unobserved and fights are resolved in one tick. Longer than the loot pause.
 
 using json = nlohmann::json;
 
-struct BossData {
-	std::string name;
-	Stats stats;
-	int exp_reward;
+// Boss definitions, each built from the pack the first time its floor comes up. Most sessions never
+// see the far floors, so they cost nothing until a player gets there. Safe to use from any thread.
+class BossTable {
+public:
+	BossTable() = default;
+	explicit BossTable(const DataPack& pack); // Keeps the pack (and its mapping) alive
+
+	const BossData* find(int floor) const; // nullptr if the floor has no boss
+	size_t size() const { return slots ? pack.bossCount() : 0; }
+
+private:
+	struct Slot {
+		std::once_flag built;
+		BossData data;
+	};
+
+	DataPack pack;
+	std::unique_ptr<Slot[]> slots; // One per pack boss, same order
+};
+
+// Everything loaded from data/. A version is published whole and never modified afterwards, so a
+// tick that grabbed one keeps using it while a hot reload swaps in the next (see DataWatcher.h).
+struct GameData {
+	std::vector<std::shared_ptr<const ItemTemplate>> item_templates;
+	BossTable bosses; // By floor, built lazily
+
+	PilotClassRegistry classes; // From classes.json, each with its level curve
+
+	uint64_t version = 0; // Counts loads, tells a cached lookup into an older version apart
+
+	LootTables loot; // Indices refer to `item_templates`
 };
 
 // Helper struct for web inventory
@@ -89,17 +128,27 @@ public:
 	Game();
 	~Game();
 
-	void loadData(const std::string& item_file, const std::string& boss_file, const std::string& level_file_path);
+	// Validates and compiles the JSON, then loadDataPack. Without a loot file ("") every floor uses the built-in rarity odds. Throws std::runtime_error.
+	void loadData(const std::string& item_file, const std::string& boss_file, const std::string& level_file_path, const std::string& loot_file_path,
+		const std::string& class_file_path);
+	void loadDataPack(const DataPack& pack); // Templates, bosses and classes from a compiled pack (see DataPack.h). Safe while the game runs.
+	// Stays valid across reloads while held. Hold it for one operation only: a reload frees the old version on its own thread once the last holder lets go.
+	std::shared_ptr<const GameData> getGameData() const { return std::atomic_load(&game_data); }
 	bool startGame(); // Returns true if successfully started
 	void stopGameLoop();
 	bool isGameRunning() const;
 
 
 	GameStateForWeb getGameState(); // Thread-safe getter for web server
+	bool isObserved() const; // True while a client has polled the game state recently
+	void markObserved(); // Counts as a poll without building the state, for responses served from a cache
+	uint64_t getStateVersion() const { return state_version.load(); } // Changes whenever anything getGameState reports may have changed
 	
 	// Thread-safe equip action
 	bool playerEquipItem(int inventory_index);
 
+	std::shared_ptr<Item> generateRandomItem(); // Creates a regular (non-boss) drop for the current floor
+
 	// Debug methods
 	void print_player_mech_stats();
 	void print_enemy_mech_stats();
@@ -107,35 +156,64 @@ public:
 	Mech player_mech;
 	Mech current_enemy;
 
-	PilotClass player_pilot_class;
+	bool initPlayerClass(const std::string& classId); // `classId` is the string id from classes.json
+	bool isClassSelected() const { return class_selected; }
 
-	// [CLASS]: [LEVEL]: [EXPERIENCE_NEEDED]
-	// "ace": 1: 10
-	std::map<std::string, std::map<int, int>> level_requirements;  
+	// Recording/Replay (see Replay.h)
+	unsigned int getSeed() const { return rng_seed; }
+	uint64_t getTickCount() const { return tick_count; }
+	bool enableRecording(const std::string& path); // Call before any command is issued
+	void runReplay(const ReplayLog& log, uint64_t until_tick = 0); // Runs on the calling thread under virtual time, 0 = until the recording ends
 
-	bool initPlayerClass(const std::string& classId);
-	bool isClassSelected() const { return class_selected; }
+	// Persistence (see SaveGame.h and Journal.h)
+	SaveSnapshot captureSnapshot(); // Thread-safe copy of the player's progress
+	bool restoreSnapshot(const SaveSnapshot& snapshot); // Call after loadData and before startGame, returns false for an unknown class
+	bool enablePersistence(const std::string& save_path); // Recovers snapshot + journal if present, then journals from here on. Throws std::runtime_error on a corrupt save.
+	void compactSave(); // Writes a snapshot and empties the journal on the calling thread, after any queued background save. For startup and shutdown.
 
 private:
 	void gameLoop(); // The function that runs in a separate thead
+	unsigned int loopSeed() const { return rng_seed + 1 + static_cast<unsigned int>(tick_count); } // Loot RNG seed each time the loop starts, a resumed save doesn't repeat its first drops
 	void gameTick(double delta_time); // Logic for one update cycle
-	void startCombat();
+	void startCombat(const GameData& data);
 	void handleCombat(double delta_time);
-	void awardLoot();
+	bool resolveCombatFastForward(); // Jumps to the end of the current fight, returns false if it can't be resolved
+	void awardLoot(const GameData& data);
 	void spawnNextEnemy();
-	void spawnBoss();
-	std::shared_ptr<Item> generateRandomItem(); // Creates an item drop
+	void spawnBoss(const GameData& data);
+	const BossData& bossForFloor(const GameData& data, int floor); // bosses.json, or generated past it. Valid until the next call.
+	const PilotClass& playerClass(const GameData& data); // The selected class in `data`, looked up by string again only after a reload
+	std::shared_ptr<Item> rollItem(const GameData& data, int floor, bool from_boss); // Boss drops fall back to the floor's table
+	static void buildLootTables(const DataPack& pack, GameData& data);
 	void logEvent(const std::string& message);
+	void recordCommand(const ReplayCommand& command); // No-op unless recording
+	void applyReplayCommand(const ReplayCommand& command);
+	void journalEvent(const JournalEvent& event); // No-op unless persistence is enabled
+	void persistIfDue(); // Game loop hook: queues batched journal fsyncs and periodic compactions on `save_worker`
+	void requestCompaction(); // Captures under the lock and queues the encode/write/compact on `save_worker`
+
+	// What a save needs, captured under the lock by bumping refcounts instead of copying items.
+	// Items never change after construction, so sharing them with the save thread is safe.
+	struct SaveCapture {
+		SaveSnapshot fields; // Everything except the items
+		std::vector<std::pair<EquipmentSlot, std::shared_ptr<const Item>>> equipment;
+		std::vector<std::shared_ptr<const Item>> inventory;
+	};
+	SaveCapture captureForSave();
+	static SaveSnapshot materialize(SaveCapture capture); // Copies the items out, off the game thread
 
 	bool is_enemy_boss = false;
 
 	int current_floor = 1;
 	int enemies_defeated_on_floor = 0;
 	const int ENEMIES_PER_FLOOR = 20; // Enemies before boss
+	EnemyScalingTable enemy_scaling{ENEMIES_PER_FLOOR}; // Precomputed grunt stat blocks
+	BossGenerator boss_generator; // Bosses for the floors past bosses.json
 
-	// Data loaded from JSON
-	std::vector<std::shared_ptr<const ItemTemplate>> item_templates;
-	std::map<int, BossData> boss_data; // Floor -> BossData
+	// Data loaded from data/, only accessed through std::atomic_load/atomic_store. Each tick loads it once
+	// and passes it down, so a reload lands between ticks and never blocks one.
+	std::shared_ptr<const GameData> game_data = std::make_shared<const GameData>();
+	std::atomic<uint64_t> data_loads{0}; // Source of GameData::version
 
 	// Game loop control
 	std::thread game_thread;
@@ -148,11 +226,36 @@ private:
 	double time_since_last_action = 0.0;
 	double turn_delay = 0.5; // Base time between turns/actions
 
+	// Milliseconds (steady clock) of the last getGameState call, used to detect unobserved sessions
+	std::atomic<long long> last_observed_ms{0};
+
+	// Bumped by every tick and command, lets the web layer reuse a serialized state until it moves
+	std::atomic<uint64_t> state_version{0};
+
 	// Logging
 	std::vector<std::string> game_log;
 	const size_t MAX_LOG_SIZE = 20;
 
 	bool class_selected = false;
+	std::string player_class_key; // String id of the selected class, what saves and recordings store
+	PilotClassId player_class_id = NO_PILOT_CLASS; // Into the registry of the GameData version numbered player_class_version
+	uint64_t player_class_version = 0; // 0 = look it up again
+	bool restored_from_save = false; // startGame keeps the restored progress and gear instead of starting fresh
+
+	// Persistence
+	std::string save_path; // Empty unless enablePersistence was called
+	EventJournal journal;
+	std::atomic<bool> compaction_requested{false}; // Set when a snapshot is needed before the next journal flush
+	std::atomic<bool> compaction_in_flight{false}; // A queued or running compaction, stops the size threshold from queuing another
+	SaveWorker save_worker; // Declared after `journal` so its queued jobs finish before the journal closes
+
+	// Determinism: the seed drives every roll, tick_count stamps recorded commands
+	unsigned int rng_seed = 0;
+	uint64_t tick_count = 0; // Ticks simulated since construction, or since the session began for a restored save
+	ReplayRecorder recorder;
+	bool replay_mode = false; // Virtual time, no game thread and no loot pause
+	bool replay_observed = false; // Observation state driven by the recording while replaying
+	bool last_tick_observed = false;
 };
 
 #endif // GAME_H
@@ -2,16 +2,26 @@
 #define GAMECLASSES_H
 
 #include <string>
-#include <iostream>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
 
-#include "Mech.h"
+#include "Stats.h"
+#include "LevelCurve.h"
 
-enum class ClassArchetype {
-	Bulwark,
-	Ace,
-	Technocrat,
-	None
-};
+/* Pilot classes
+	Classes come from data/classes.json, one entry per class with its base stats and passive, and its
+	level curve from levels.json. Adding a class is a data change.
+
+	Each class gets a compact id, its position in classes.json. The engine holds on to that id and
+	indexes the registry with it. The string id ("ace") is only looked up where a class comes in from
+	outside: /init_game, saves and recordings, which keep the string so they survive the file being
+	reordered.
+*/
+
+typedef uint32_t PilotClassId;
+#define NO_PILOT_CLASS UINT32_MAX
 
 struct ClassPassive {
    std::string id;
@@ -19,79 +29,33 @@ struct ClassPassive {
 };
 
 struct PilotClass {
-   std::string id;
-   ClassArchetype archetype;
+   PilotClassId id = NO_PILOT_CLASS;
+   std::string key; // The string id from classes.json
+   std::string name;
    Stats stats;
    ClassPassive passive;
+   LevelCurve level_curve;
 };
 
-
-class PilotClassFactory {
+class PilotClassRegistry {
 public:
-   static PilotClass createPilotClass(std::string classId) {
-	PilotClass pC;
-	pC.id = classId;
-	pC.archetype = ClassArchetype::None;
-
-	// --- 1. THE BULWARK (Tank) ---
-	if (classId == "bulwark") {
-	   pC.archetype = ClassArchetype::Bulwark;
-	   pC.stats = {
-		{StatType::HEALTH, 250},
-		{StatType::ARMOR, 10},
-		{StatType::ENERGY_SHIELD, 50},
-		{StatType::ATTACK, 2},
-		{StatType::ATTACK_SPEED, 1},
-		{StatType::MOBILITY, 1},
-		{StatType::ENERGY, 1},
-		{StatType::ENERGY_RECOVERY, 1},
-		{StatType::REPAIR, 5},
-		{StatType::TECHNOLOGY, 1},
-	   };
-
-	   pC.passive.id = "TANK MODE";
-	   pC.passive.description = "I AM TANKKKKK!!!";
+	// Takes the next id, classes are added in classes.json order
+	void add(PilotClass pilot_class) {
+		pilot_class.id = static_cast<PilotClassId>(classes.size());
+		ids.emplace(pilot_class.key, pilot_class.id);
+		classes.push_back(std::move(pilot_class));
 	}
-	// --- 2. THE ACE (DPS/Speed) ---
-	else if (classId == "ace") {
-	   pC.archetype = ClassArchetype::Ace;
-	   pC.stats = {
-		{StatType::HEALTH, 150},
-		{StatType::ARMOR, 4},
-		{StatType::ENERGY_SHIELD, 30},
-		{StatType::ATTACK, 5},
-		{StatType::ATTACK_SPEED, 2.5},
-		{StatType::MOBILITY, 8},
-		{StatType::ENERGY, 20},
-		{StatType::ENERGY_RECOVERY, 2},
-		{StatType::REPAIR, 1},
-		{StatType::TECHNOLOGY, 2},
-	   };
 
-	   pC.passive.id = "OVERCLOCK";
-	   pC.passive.description = "Perfect accuracy; no failure.";
+	const PilotClass& get(PilotClassId id) const { return classes[id]; } // `id` must come from this registry
+	const PilotClass* find(std::string_view key) const { // nullptr for an unknown class
+		auto it = ids.find(std::string(key));
+		return it != ids.end() ? &classes[it->second] : nullptr;
 	}
-	// --- 3. THE TECHNOCRAT (Utility/Scaling) ---
-	else if (classId == "technocrat") {
-	   pC.archetype = ClassArchetype::Technocrat;
-	   pC.stats = {
-		{StatType::HEALTH, 120},
-		{StatType::ARMOR, 2},
-		{StatType::ENERGY_SHIELD, 100},
-		{StatType::ATTACK, 3},
-		{StatType::ATTACK_SPEED, 1.2},
-		{StatType::MOBILITY, 3},
-		{StatType::ENERGY, 50},
-		{StatType::ENERGY_RECOVERY, 5},
-		{StatType::REPAIR, 2},
-		{StatType::TECHNOLOGY, 10},
-	   };
+	size_t size() const { return classes.size(); }
 
-	   pC.passive.id = "NANOBOTS";
-	   pC.passive.description = "Logic beats brute force.";
-	}
-
-	return pC;
-   }
+private:
+	std::vector<PilotClass> classes; // Indexed by id
+	std::unordered_map<std::string, PilotClassId> ids; // String id -> id
 };
-#endif // GAMECLASSES_H 
+
+#endif // GAMECLASSES_H
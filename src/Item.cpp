@@ -1,15 +1,60 @@
 #include <iostream>
 #include <random>
 #include <chrono> // For seeding random
+#include <limits>
 
 #include "Item.h"
 
+namespace {
+
+struct RarityModifier {
+	double variation;    // The roll lands within +- this fraction
+	double base_multiplier;
+};
+
+const RarityModifier RARITY_MODIFIERS[] = { // Indexed by Rarity
+	{0.10, 1.00}, // COMMON: +/- 10%
+	{0.25, 1.25}, // UNCOMMON: +/- 25% + 25% base
+	{0.50, 1.75}, // RARE: +/- 50% + 75% base
+	{1.00, 2.25}, // LEGENDARY: +/- 100%, +125% base
+};
+static_assert(sizeof(RARITY_MODIFIERS) / sizeof(RARITY_MODIFIERS[0]) == RARITY_NAMES.size(), "one modifier per rarity");
+
+void buildStatRolls(ItemTemplate& tpl) {
+	const double infinity = std::numeric_limits<double>::infinity();
+	tpl.stat_rolls.clear();
+	tpl.stat_rolls.reserve(RARITY_NAMES.size() * tpl.base_stats.size());
+	for (const RarityModifier& modifier : RARITY_MODIFIERS) {
+		for (const auto& [type, base_value] : tpl.base_stats) {
+			StatRoll roll;
+			roll.type = type;
+			roll.base = base_value * modifier.base_multiplier;
+			roll.variation = modifier.variation;
+			roll.min_value = (base_value >= 0) ? 0.0 : -infinity; // Stats don't go negative if the base wasn't
+			roll.max_value = infinity;
+			if (type == StatType::ARMOR) { // Armor is capped at 0% to 90%
+				roll.min_value = 0.0;
+				roll.max_value = 0.9;
+			}
+			tpl.stat_rolls.push_back(roll);
+		}
+	}
+	tpl.technology_stat = getStat(tpl.base_stats, StatType::TECHNOLOGY);
+}
+
+} // namespace
+
+std::shared_ptr<const ItemTemplate> makeItemTemplate(ItemTemplate tpl) {
+	buildStatRolls(tpl);
+	return std::make_shared<const ItemTemplate>(std::move(tpl));
+}
+
 // --- Getters ---
-std::string Item::getName() const {
+std::string_view Item::getName() const {
 	return item_template->name;
 }
 
-std::string Item::getDescription() const {
+std::string_view Item::getDescription() const {
 	return item_template->description;
 }
 
@@ -26,10 +71,10 @@ const Stats& Item::getStats() const {
 }
 
 int Item::getRequiredTech() const {
-	return getStat(item_template->base_stats, StatType::TECHNOLOGY);
+	return item_template->technology_stat;
 }
 
-std::string Item::getId() const {
+std::string_view Item::getId() const {
 	return item_template->id;
 }
 
@@ -44,6 +89,9 @@ Item::Item(std::shared_ptr<const ItemTemplate> t, Rarity r) : item_template(t),
 		// To handle error will be throwing and exception
 		throw std::runtime_error("Item constructor: ItemTemplate pointer is null.");
 	}
+	if (item_template->stat_rolls.size() != RARITY_NAMES.size() * item_template->base_stats.size()) {
+		throw std::runtime_error("Item constructor: ItemTemplate '" + std::string(item_template->id) + "' has no stat rolls, it was not made with makeItemTemplate.");
+	}
 
 	// After initializing the tempalte and rarity, generate the specific stats for this instance
 	generateInstanceStats();
@@ -51,42 +99,26 @@ Item::Item(std::shared_ptr<const ItemTemplate> t, Rarity r) : item_template(t),
 	std::cout << "Created Item: " << getName() << " (" << rarityToString(getRarity()) << ")" << std::endl;
 }
 
-
-void Item::generateInstanceStats() {
-	instance_stats = item_template->base_stats; // Start with base
-
-	double variation_percent = 0.0;
-	double flat_bonus_mult = 1.0; // Multiplier for base stats
-
-	switch (rarity) {
-		case Rarity::COMMON:	variation_percent = 0.10; break; // +/- 10%
-		case Rarity::UNCOMMON:  variation_percent = 0.25; flat_bonus_mult = 1.25; break; // +/- 25% + 25% base
-		case Rarity::RARE:		variation_percent = 0.50; flat_bonus_mult = 1.75; break; // +/- 50% + 75% base
-		case Rarity::LEGENDARY: variation_percent = 1.00; flat_bonus_mult = 2.25; break; // +/- 100%, +125% base
+Item::Item(std::shared_ptr<const ItemTemplate> t, Rarity r, Stats rolled_stats) : item_template(t), rarity(r), instance_stats(std::move(rolled_stats)) {
+	if (!item_template) {
+		throw std::runtime_error("Item constructor: ItemTemplate pointer is null.");
 	}
+}
 
-	Stats final_stats;
-	for (const auto& pair : item_template->base_stats) {
-		StatType type = pair.first;
-		double base_value = pair.second;
-
-		// Apply flat bonus multiplier first (only for Uncommon+)
-		double modified_base = (rarity == Rarity::COMMON) ? base_value : base_value * flat_bonus_mult;
-
-		// Apply percentage variation
-		double variation = myRandomDouble(-variation_percent, variation_percent); // e.g., random between -0.1 and 0.1
-		double final_value = modified_base * (1.0 + variation);
 
-		// Ensure stats don't go negative if base was non-negative
-		if (base_value >= 0 && final_value < 0) {
-			final_value = 0;
-		}
-		// Armor should probably be capped (e.g., 0% to 90%)
-		if (type == StatType::ARMOR) {
-			final_value = std::max(0.0, std::min(0.9, final_value)); // Example cap 0-90%
-		}
+void Item::generateInstanceStats() {
+	// NOTE(MSR): The bounds come precomputed per template and rarity (see buildStatRolls). The draws and
+	// the arithmetic are the same as when they were worked out here, so a seed still rolls the same items.
+	const size_t stat_count = item_template->base_stats.size();
+	const StatRoll* rolls = item_template->stat_rolls.data() + static_cast<size_t>(rarity) * stat_count;
 
-		final_stats[type] = final_value;
+	Stats final_stats;
+	for (size_t i = 0; i < stat_count; i++) {
+		const StatRoll& roll = rolls[i];
+		double value = roll.base * (1.0 + myRandomDouble(-roll.variation, roll.variation));
+		if (value < roll.min_value) value = roll.min_value;
+		if (value > roll.max_value) value = roll.max_value;
+		final_stats.emplace_hint(final_stats.end(), roll.type, value); // Rolls are in StatType order
 	}
-	instance_stats = final_stats; // Assign calculated stats
+	instance_stats = std::move(final_stats);
 }
@@ -2,31 +2,51 @@
 #define ITEM_H
 
 #include <string>
+#include <string_view>
 #include <memory>
+#include <vector>
 #include "Stats.h"
 #include "Utils.h"
 
+// One stat of an item roll, for one template at one rarity. The rolled value is
+// base * (1 + a uniform draw in [-variation, variation]), clamped to [min_value, max_value].
+struct StatRoll {
+	StatType type;
+	double base; // The template's value with the rarity's bonus applied
+	double variation;
+	double min_value;
+	double max_value;
+};
+
 struct ItemTemplate { // Data loaded from JSON
-	std::string id;
-	std::string name;
-	std::string description;
+	// Interned (see StringInterner.h), valid for the rest of the process
+	std::string_view id;
+	std::string_view name;
+	std::string_view description;
 	EquipmentSlot slot = EquipmentSlot::NONE;
 	Stats base_stats;
 	int required_tech = 0; // Technology requirement
 
+	// Derived from base_stats by makeItemTemplate, rolling an item only reads them
+	std::vector<StatRoll> stat_rolls; // Rarity-major, base_stats.size() entries per rarity, in StatType order
+	int technology_stat = 0; // TECHNOLOGY in base_stats, what Item::getRequiredTech reports
 };
 
+// Fills in the derived fields of `tpl` from its base_stats and freezes it, items need templates made here
+std::shared_ptr<const ItemTemplate> makeItemTemplate(ItemTemplate tpl);
+
 class Item {
 public:
 	Item(std::shared_ptr<const ItemTemplate> t, Rarity r);
+	Item(std::shared_ptr<const ItemTemplate> t, Rarity r, Stats rolled_stats); // Restores a saved item without re-rolling
 
-	std::string getName() const;
-	std::string getDescription() const;
+	std::string_view getName() const;
+	std::string_view getDescription() const;
 	EquipmentSlot getSlot() const;
 	Rarity getRarity() const;
 	const Stats& getStats() const;
 	int getRequiredTech() const;
-	std::string getId() const; // Returns template ID
+	std::string_view getId() const; // Returns template ID
 
 	void generateInstanceStats(); // Applies rarity modifiers
 
@@ -0,0 +1,346 @@
+#include <iostream>
+#include <stdexcept>
+#include <cstring>
+#include <cerrno>
+#include <filesystem>
+#include <algorithm>
+#include <iterator>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "Journal.h"
+#include "BinaryIO.h"
+#include "MappedFile.h"
+
+namespace {
+
+const char JOURNAL_MAGIC[4] = {'I', 'M', 'J', 'L'};
+const size_t JOURNAL_HEADER_SIZE = 8;
+const size_t RECORD_HEADER_SIZE = 8; // u32 payload_length | u32 crc32
+
+std::string journalHeader() {
+	std::string header(JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC));
+	ByteWriter writer(header);
+	writer.u16(JOURNAL_FORMAT_VERSION);
+	writer.u16(0);
+	return header;
+}
+
+std::string encodeRecord(const JournalEvent& event) {
+	std::string record;
+	record.reserve(64);
+	ByteWriter writer(record);
+	size_t length_pos = writer.placeholderU32();
+	size_t checksum_pos = writer.placeholderU32();
+
+	writer.u64(event.sequence);
+	writer.u8(static_cast<uint8_t>(event.type));
+	switch (event.type) {
+		case JournalEventType::KILL:
+			writer.i32(event.enemies_defeated_on_floor);
+			writer.i32(event.experience);
+			break;
+		case JournalEventType::LOOT:
+			writer.item(event.item);
+			break;
+		case JournalEventType::EQUIP:
+			writer.i32(event.inventory_index);
+			writer.u8(static_cast<uint8_t>(event.slot));
+			writer.u8(event.returned_old_item ? 1 : 0);
+			break;
+		case JournalEventType::LEVEL_UP:
+			writer.i32(event.level);
+			break;
+		case JournalEventType::FLOOR_ADVANCE:
+			writer.i32(event.floor);
+			writer.i32(event.enemies_defeated_on_floor);
+			break;
+	}
+
+	std::string_view payload(record.data() + RECORD_HEADER_SIZE, record.size() - RECORD_HEADER_SIZE);
+	writer.patchU32(length_pos, static_cast<uint32_t>(payload.size()));
+	writer.patchU32(checksum_pos, checksum32(payload));
+	return record;
+}
+
+// Returns false for an event type this build doesn't know, the caller skips it
+bool decodeRecord(std::string_view payload, JournalEvent& event) {
+	ByteReader reader(payload);
+	event.sequence = reader.u64();
+	uint8_t type = reader.u8();
+	event.type = static_cast<JournalEventType>(type);
+	switch (event.type) {
+		case JournalEventType::KILL:
+			event.enemies_defeated_on_floor = reader.i32();
+			event.experience = reader.i32();
+			return true;
+		case JournalEventType::LOOT:
+			event.item = reader.item();
+			return true;
+		case JournalEventType::EQUIP: {
+			event.inventory_index = reader.i32();
+			uint8_t slot = reader.u8();
+			event.slot = (slot <= LAST_EQUIPMENT_SLOT) ? static_cast<EquipmentSlot>(slot) : EquipmentSlot::NONE;
+			event.returned_old_item = reader.u8() != 0;
+			return true;
+		}
+		case JournalEventType::LEVEL_UP:
+			event.level = reader.i32();
+			return true;
+		case JournalEventType::FLOOR_ADVANCE:
+			event.floor = reader.i32();
+			event.enemies_defeated_on_floor = reader.i32();
+			return true;
+	}
+	return false;
+}
+
+// Parses records until the data ends or a record is torn/corrupt. Returns the offset just past the last good record.
+size_t scanJournal(std::string_view data, const std::string& path, std::vector<JournalEvent>* events) {
+	if (data.size() < JOURNAL_HEADER_SIZE || data.compare(0, sizeof(JOURNAL_MAGIC), std::string_view(JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC))) != 0) {
+		throw std::runtime_error("Journal: not a journal file: " + path);
+	}
+	ByteReader header(data.substr(sizeof(JOURNAL_MAGIC), JOURNAL_HEADER_SIZE - sizeof(JOURNAL_MAGIC)));
+	uint16_t version = header.u16();
+	if (version > JOURNAL_FORMAT_VERSION) {
+		throw std::runtime_error("Journal: format " + std::to_string(version) + " needs a newer server: " + path);
+	}
+
+	size_t pos = JOURNAL_HEADER_SIZE;
+	while (data.size() - pos >= RECORD_HEADER_SIZE) {
+		ByteReader record_header(data.substr(pos, RECORD_HEADER_SIZE));
+		uint32_t length = record_header.u32();
+		uint32_t checksum = record_header.u32();
+		if (length > data.size() - pos - RECORD_HEADER_SIZE) break; // Torn write at the tail
+
+		std::string_view payload = data.substr(pos + RECORD_HEADER_SIZE, length);
+		if (checksum32(payload) != checksum) break;
+
+		if (events) {
+			JournalEvent event;
+			try {
+				if (decodeRecord(payload, event)) events->push_back(std::move(event));
+			} catch (const std::runtime_error&) {
+				break; // Checksum matched but the payload is short, treat as the end
+			}
+		}
+		pos += RECORD_HEADER_SIZE + length;
+	}
+	return pos;
+}
+
+} // namespace
+
+EventJournal::~EventJournal() {
+	if (fd >= 0) {
+		try {
+			flush();
+		} catch (const std::exception& e) {
+			std::cerr << "Journal: final flush failed: " << e.what() << std::endl;
+		}
+		close(fd);
+	}
+}
+
+void EventJournal::open(const std::string& journal_path, uint64_t last_sequence) {
+	std::lock_guard<std::mutex> io_lock(io_mutex);
+	std::lock_guard<std::mutex> lock(mutex);
+	path = journal_path;
+	next_sequence = last_sequence + 1;
+	pending.clear();
+	written.clear();
+
+	// Cut off a torn tail first, anything appended after it would be unreadable
+	size_t valid_end = 0;
+	MappedFile existing;
+	if (mapFile(path, existing) && !existing.contents.empty()) {
+		valid_end = scanJournal(existing.contents, path, nullptr);
+	}
+	written_events = 0;
+
+	fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC, 0644);
+	if (fd < 0) {
+		throw std::runtime_error("Journal: failed to open " + path + ": " + std::strerror(errno));
+	}
+	if (valid_end == 0) {
+		if (ftruncate(fd, 0) != 0) {
+			throw std::runtime_error("Journal: failed to truncate " + path + ": " + std::strerror(errno));
+		}
+		writeAll(fd, journalHeader(), path);
+		valid_end = JOURNAL_HEADER_SIZE;
+	} else if (ftruncate(fd, static_cast<off_t>(valid_end)) != 0) {
+		throw std::runtime_error("Journal: failed to truncate " + path + ": " + std::strerror(errno));
+	}
+	lseek(fd, 0, SEEK_END);
+	fdatasync(fd);
+}
+
+uint64_t EventJournal::append(JournalEvent event) {
+	std::lock_guard<std::mutex> lock(mutex);
+	event.sequence = next_sequence++;
+	pending.emplace_back(event.sequence, encodeRecord(event));
+	return event.sequence;
+}
+
+uint64_t EventJournal::lastSequence() {
+	std::lock_guard<std::mutex> lock(mutex);
+	return next_sequence - 1;
+}
+
+size_t EventJournal::eventsSinceCompaction() {
+	std::lock_guard<std::mutex> lock(mutex);
+	return written_events + pending.size();
+}
+
+bool EventJournal::isFlushDue() {
+	std::lock_guard<std::mutex> lock(mutex);
+	if (pending.empty()) return false;
+	auto now = std::chrono::steady_clock::now();
+	return pending.size() >= JOURNAL_FSYNC_BATCH || now - last_flush >= std::chrono::milliseconds(JOURNAL_FSYNC_INTERVAL_MS);
+}
+
+void EventJournal::flushIfDue() {
+	if (isFlushDue()) flush();
+}
+
+void EventJournal::flush() {
+	std::lock_guard<std::mutex> io_lock(io_mutex);
+
+	// Take the batch and let go of `mutex` before touching the disk, so append() never waits on an fsync
+	std::vector<std::pair<uint64_t, std::string>> batch;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		batch.swap(pending);
+		last_flush = std::chrono::steady_clock::now();
+	}
+	if (fd < 0 || batch.empty()) return;
+
+	// One write and one fdatasync for the whole batch
+	std::string bytes;
+	for (const auto& record : batch) {
+		bytes += record.second;
+	}
+	writeAll(fd, bytes, path);
+	if (fdatasync(fd) != 0) {
+		throw std::runtime_error("Journal: failed to sync " + path + ": " + std::strerror(errno));
+	}
+
+	std::move(batch.begin(), batch.end(), std::back_inserter(written));
+	std::lock_guard<std::mutex> lock(mutex);
+	written_events = written.size();
+}
+
+void EventJournal::compactThrough(uint64_t sequence) {
+	std::lock_guard<std::mutex> io_lock(io_mutex);
+	if (fd < 0) return;
+
+	// The snapshot was captured before this runs, so a flush in between may have written events it doesn't
+	// contain. Those are carried over into the compacted file instead of being dropped with the rest.
+	auto covered = [sequence](const auto& record) { return record.first <= sequence; };
+	written.erase(std::remove_if(written.begin(), written.end(), covered), written.end());
+	std::string survivors;
+	for (const auto& record : written) {
+		survivors += record.second;
+	}
+
+	if (survivors.empty()) {
+		if (ftruncate(fd, JOURNAL_HEADER_SIZE) != 0) {
+			throw std::runtime_error("Journal: failed to truncate " + path + ": " + std::strerror(errno));
+		}
+		lseek(fd, 0, SEEK_END);
+		fdatasync(fd);
+	} else {
+		// Truncating and then rewriting would lose the survivors to a crash in between, so swap in a new file
+		std::string tmp_path = path + ".tmp";
+		int tmp_fd = ::open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+		if (tmp_fd < 0) {
+			throw std::runtime_error("Journal: failed to open " + tmp_path + ": " + std::strerror(errno));
+		}
+		try {
+			writeAll(tmp_fd, journalHeader() + survivors, tmp_path);
+			if (fdatasync(tmp_fd) != 0) {
+				throw std::runtime_error("Journal: failed to sync " + tmp_path + ": " + std::strerror(errno));
+			}
+		} catch (...) {
+			close(tmp_fd);
+			unlink(tmp_path.c_str());
+			throw;
+		}
+		if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+			int error = errno;
+			close(tmp_fd);
+			unlink(tmp_path.c_str());
+			throw std::runtime_error("Journal: failed to rename " + tmp_path + ": " + std::strerror(error));
+		}
+		close(fd);
+		fd = tmp_fd; // Already positioned at the end
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+	written_events = written.size();
+	pending.erase(std::remove_if(pending.begin(), pending.end(), covered), pending.end());
+}
+
+std::vector<JournalEvent> readJournal(const std::string& path) {
+	std::vector<JournalEvent> events;
+	MappedFile mapped;
+	if (!mapFile(path, mapped) || mapped.contents.empty()) {
+		return events;
+	}
+	scanJournal(mapped.contents, path, &events);
+	return events;
+}
+
+void applyJournalEvent(SaveSnapshot& snapshot, const JournalEvent& event) {
+	switch (event.type) {
+		case JournalEventType::KILL:
+			snapshot.enemies_defeated_on_floor = event.enemies_defeated_on_floor;
+			snapshot.player_experience = event.experience;
+			break;
+		case JournalEventType::LOOT:
+			// Drops aren't kept yet (see Game::awardLoot), the record is there for when they are
+			break;
+		case JournalEventType::EQUIP: {
+			if (event.inventory_index < 0 || event.inventory_index >= static_cast<int>(snapshot.inventory.size())) break;
+			SavedItem item = std::move(snapshot.inventory[event.inventory_index]);
+			snapshot.inventory.erase(snapshot.inventory.begin() + event.inventory_index);
+
+			auto it = std::find_if(snapshot.equipment.begin(), snapshot.equipment.end(), [&event](const auto& entry) { return entry.first == event.slot; });
+			if (it != snapshot.equipment.end()) {
+				if (event.returned_old_item) snapshot.inventory.push_back(std::move(it->second));
+				it->second = std::move(item);
+			} else {
+				snapshot.equipment.emplace_back(event.slot, std::move(item));
+			}
+			break;
+		}
+		case JournalEventType::LEVEL_UP:
+			snapshot.player_level = event.level;
+			break;
+		case JournalEventType::FLOOR_ADVANCE:
+			snapshot.current_floor = event.floor;
+			snapshot.enemies_defeated_on_floor = event.enemies_defeated_on_floor;
+			break;
+	}
+	snapshot.journal_sequence = event.sequence;
+}
+
+bool recoverSave(const std::string& save_path, const std::string& journal_path, SaveSnapshot& snapshot) {
+	if (!std::filesystem::exists(save_path)) {
+		if (std::filesystem::exists(journal_path)) {
+			std::cerr << "Journal: " << journal_path << " has no snapshot to apply to, ignoring it." << std::endl;
+		}
+		return false;
+	}
+
+	snapshot = loadSnapshotFile(save_path);
+	size_t applied = 0;
+	for (const JournalEvent& event : readJournal(journal_path)) {
+		if (event.sequence <= snapshot.journal_sequence) continue; // Already in the snapshot
+		applyJournalEvent(snapshot, event);
+		applied++;
+	}
+	std::cout << "Journal: replayed " << applied << " events on top of " << save_path << std::endl;
+	return true;
+}
@@ -0,0 +1,103 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <chrono>
+#include <cstdint>
+
+#include "SaveGame.h"
+
+/* Append-only event journal
+	Between snapshots, every state change that matters for a save (kill, loot, equip, level-up,
+	floor advance) is appended to `<save>.journal`. Writes are buffered and made durable in batches,
+	so losing power costs at most JOURNAL_FSYNC_INTERVAL_MS of progress while the disk only sees
+	small sequential appends. Once JOURNAL_COMPACT_EVENTS have piled up the game writes a fresh
+	snapshot and the journal starts over. Flushes and compactions run on the game's SaveWorker thread.
+
+	File layout, little-endian:
+		header   "IMJL" | u16 version | u16 reserved
+		records  u32 payload_length | u32 crc32(payload) | payload( u64 sequence | u8 type | fields )
+
+	Recovery loads the snapshot and applies every record whose sequence is newer than the
+	snapshot's `journal_sequence`, so a crash between writing a snapshot and truncating the
+	journal never applies an event twice. Reading stops at the first torn or corrupt record.
+
+	Events carry resulting values (EXP, level, floor) rather than deltas where they can, which keeps
+	replaying them simple and idempotent.
+*/
+
+#define JOURNAL_FORMAT_VERSION 1
+#define JOURNAL_FSYNC_INTERVAL_MS 200 // Longest a buffered event waits before being made durable
+#define JOURNAL_FSYNC_BATCH 64 // Flush early once this many events are waiting
+#define JOURNAL_COMPACT_EVENTS 2000 // Events after which the journal is folded into a new snapshot
+
+enum class JournalEventType : uint8_t {
+	KILL = 1,          // enemies_defeated_on_floor, experience
+	LOOT = 2,          // item
+	EQUIP = 3,         // inventory_index, slot, returned_old_item
+	LEVEL_UP = 4,      // level
+	FLOOR_ADVANCE = 5  // floor, enemies_defeated_on_floor
+};
+
+struct JournalEvent {
+	uint64_t sequence = 0; // Assigned by EventJournal::append
+	JournalEventType type = JournalEventType::KILL;
+
+	int enemies_defeated_on_floor = 0;
+	int experience = 0;
+	int level = 0;
+	int floor = 0;
+	int inventory_index = 0;
+	EquipmentSlot slot = EquipmentSlot::NONE;
+	bool returned_old_item = false; // Whether the replaced item went back into the inventory
+	SavedItem item;
+};
+
+class EventJournal {
+public:
+	~EventJournal();
+
+	// Opens (creating if needed) the journal for appending, new events are numbered after `last_sequence`.
+	// Throws std::runtime_error on failure.
+	void open(const std::string& path, uint64_t last_sequence);
+	bool isOpen() const { return fd >= 0; }
+
+	// Buffers an event and returns its sequence number. Cheap, never touches the disk.
+	uint64_t append(JournalEvent event);
+	uint64_t lastSequence();
+	size_t eventsSinceCompaction();
+
+	bool isFlushDue(); // True once the batch or interval is reached
+	void flushIfDue(); // Writes and fsyncs buffered events if isFlushDue()
+	void flush();      // Writes and fsyncs everything buffered now
+
+	// Drops every event up to and including `sequence` (now covered by a snapshot) and rewrites the file
+	// with the written events newer than that. Buffered events newer than `sequence` are written on the next flush.
+	// Safe to call while other threads append or flush: events the snapshot missed are never lost.
+	void compactThrough(uint64_t sequence);
+
+private:
+	std::mutex io_mutex; // Serializes file writes and truncation, taken before `mutex`
+	std::mutex mutex;    // Guards the fields below, never held across disk I/O
+	std::string path;
+	int fd = -1;
+	uint64_t next_sequence = 1;
+	std::vector<std::pair<uint64_t, std::string>> pending; // (sequence, encoded record) not yet written
+	std::vector<std::pair<uint64_t, std::string>> written; // Records in the file since the last compaction, guarded by `io_mutex`
+	size_t written_events = 0; // written.size(), readable under `mutex`
+	std::chrono::steady_clock::time_point last_flush = std::chrono::steady_clock::now();
+};
+
+// Reads every intact record of a journal, stopping at the first torn or corrupt one.
+// A missing file is an empty journal. Throws std::runtime_error if the header is wrong.
+std::vector<JournalEvent> readJournal(const std::string& path);
+
+// Folds one event into a snapshot, mirroring what the game did when it was recorded
+void applyJournalEvent(SaveSnapshot& snapshot, const JournalEvent& event);
+
+// Snapshot + journal tail. Returns false if neither file exists (a new game).
+bool recoverSave(const std::string& save_path, const std::string& journal_path, SaveSnapshot& snapshot);
+
+#endif // JOURNAL_H
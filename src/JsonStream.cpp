@@ -0,0 +1,110 @@
+#include <stdexcept>
+#include <iterator>
+#include <algorithm>
+
+#include "JsonStream.h"
+
+namespace {
+
+// Feeds the parser one byte at a time like a plain pointer would, and leaves behind how far it got
+struct TrackingIterator {
+	using iterator_category = std::input_iterator_tag;
+	using value_type = char;
+	using difference_type = std::ptrdiff_t;
+	using pointer = const char*;
+	using reference = const char&;
+
+	const char* position;
+	const char** cursor;
+
+	reference operator*() const { return *position; }
+	TrackingIterator& operator++() {
+		*cursor = ++position;
+		return *this;
+	}
+	bool operator==(const TrackingIterator& other) const { return position == other.position; }
+	bool operator!=(const TrackingIterator& other) const { return position != other.position; }
+};
+
+} // namespace
+
+void JsonStreamReader::read(std::string_view source) {
+	text = source;
+	cursor = text.data();
+	frames.clear();
+	opening = false;
+	json::sax_parse(TrackingIterator{text.data(), &cursor}, TrackingIterator{text.data() + text.size(), &cursor}, this);
+}
+
+void JsonStreamReader::fail(size_t at, const std::string& message) const {
+	at = std::min(at, text.size());
+	size_t line = 1 + std::count(text.begin(), text.begin() + at, '\n');
+	size_t line_start = text.rfind('\n', at == 0 ? 0 : at - 1);
+	size_t column = (line_start == std::string_view::npos || at == 0) ? at + 1 : at - line_start;
+	throw std::runtime_error(file_name + ":" + std::to_string(line) + ":" + std::to_string(column) + ": " + message);
+}
+
+void JsonStreamReader::fail(const std::string& message) const {
+	if (frames.empty()) fail(offset(), message);
+	if (opening) {
+		// The value being read is the container that just opened, point at its key if it has one
+		const Frame* parent = frames.size() > 1 ? &frames[frames.size() - 2] : nullptr;
+		fail((parent && !parent->is_array) ? parent->key_offset : frames.back().open_offset, message);
+	}
+	fail(frames.back().is_array ? offset() : frames.back().key_offset, message);
+}
+
+bool JsonStreamReader::scalar(const json& value) {
+	onValue(value);
+	if (inArray()) frames.back().index++;
+	return true;
+}
+
+bool JsonStreamReader::open(bool is_array) {
+	Frame frame;
+	frame.is_array = is_array;
+	frame.open_offset = offset() - 1; // The bracket was the last byte read
+	frames.push_back(std::move(frame));
+	opening = true;
+	is_array ? onBeginArray() : onBeginObject();
+	opening = false;
+	return true;
+}
+
+void JsonStreamReader::close() {
+	frames.back().is_array ? onEndArray() : onEndObject();
+	frames.pop_back();
+	if (inArray()) frames.back().index++;
+}
+
+bool JsonStreamReader::null() { return scalar(json(nullptr)); }
+bool JsonStreamReader::boolean(bool value) { return scalar(json(value)); }
+bool JsonStreamReader::number_integer(json::number_integer_t value) { return scalar(json(value)); }
+bool JsonStreamReader::number_unsigned(json::number_unsigned_t value) { return scalar(json(value)); }
+bool JsonStreamReader::number_float(json::number_float_t value, const std::string&) { return scalar(json(value)); }
+bool JsonStreamReader::string(std::string& value) { return scalar(json(std::move(value))); }
+bool JsonStreamReader::binary(json::binary_t&) { return true; } // Text JSON never produces binary values
+
+bool JsonStreamReader::start_object(std::size_t) { return open(false); }
+bool JsonStreamReader::end_object() { close(); return true; }
+bool JsonStreamReader::start_array(std::size_t) { return open(true); }
+bool JsonStreamReader::end_array() { close(); return true; }
+
+bool JsonStreamReader::key(std::string& name) {
+	Frame& frame = frames.back();
+	frame.key = std::move(name);
+	// The closing quote was the last byte read, point at the opening one
+	size_t end = offset() - 1;
+	size_t start = end;
+	while (start > 0 && !(text[start - 1] == '"' && (start < 2 || text[start - 2] != '\\'))) start--;
+	frame.key_offset = (start > 0) ? start - 1 : end;
+	return true;
+}
+
+bool JsonStreamReader::parse_error(std::size_t position, const std::string&, const nlohmann::detail::exception& ex) {
+	// nlohmann counts from 1 and names the byte it could not use
+	std::string message = ex.what();
+	size_t detail = message.find(": ");
+	if (detail != std::string::npos && message.compare(0, 1, "[") == 0) message = message.substr(detail + 2);
+	fail(position > 0 ? position - 1 : 0, message);
+}
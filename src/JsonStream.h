@@ -0,0 +1,97 @@
+#ifndef JSONSTREAM_H
+#define JSONSTREAM_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+
+#include "json.hpp" // nlohmann/json
+
+/* Streaming JSON reader
+	A base for nlohmann SAX handlers that build records straight from the events, without a DOM in
+	between (see the data-file readers in DataPack.cpp). It keeps the path of open containers and the
+	byte offset the parser has reached, so a handler can report "items.json:14:9: unknown stat 'FOO'"
+	instead of only the entry index.
+
+	Subclasses override the hooks they care about. Inside a hook, depth() is the number of open
+	containers (1 = inside the top-level value) and key()/index() describe the member being read.
+	Hooks report problems by calling fail(), which throws std::runtime_error.
+*/
+
+class JsonStreamReader {
+public:
+	using json = nlohmann::json;
+
+	explicit JsonStreamReader(std::string file_name) : file_name(std::move(file_name)) {}
+	virtual ~JsonStreamReader() = default;
+
+	// Parses `text` from start to end, throws std::runtime_error with the file, line and column on
+	// syntax errors and on anything a hook rejects.
+	void read(std::string_view text);
+
+	const std::string& fileName() const { return file_name; }
+
+	// nlohmann's SAX interface, forwarded to the hooks below
+	bool null();
+	bool boolean(bool value);
+	bool number_integer(json::number_integer_t value);
+	bool number_unsigned(json::number_unsigned_t value);
+	bool number_float(json::number_float_t value, const std::string& raw);
+	bool string(std::string& value);
+	bool binary(json::binary_t& value);
+	bool start_object(std::size_t elements);
+	bool key(std::string& name);
+	bool end_object();
+	bool start_array(std::size_t elements);
+	bool end_array();
+	bool parse_error(std::size_t position, const std::string& last_token, const nlohmann::detail::exception& ex);
+
+protected:
+	// A scalar value, an object or an array opened or closed at the current position
+	virtual void onValue(const json& value) { (void)value; }
+	virtual void onBeginObject() {}
+	virtual void onEndObject() {}
+	virtual void onBeginArray() {}
+	virtual void onEndArray() {}
+
+	size_t depth() const { return frames.size(); }
+	bool inArray() const { return !frames.empty() && frames.back().is_array; }
+	// Member name (objects) or element index (arrays) of the value being read in the innermost container
+	const std::string& key() const { return frames.back().key; }
+	size_t index() const { return frames.back().index; }
+	// Same, for the container open at `level` (1 = the top-level value)
+	const std::string& keyAt(size_t level) const { return frames[level - 1].key; }
+	size_t indexAt(size_t level) const { return frames[level - 1].index; }
+
+	// Offset of the innermost container's opening bracket and of the current member's key
+	size_t containerOffset() const { return frames.back().open_offset; }
+	size_t keyOffset() const { return frames.back().key_offset; }
+	size_t offset() const { return static_cast<size_t>(cursor - text.data()); }
+
+	// Throws "<file>:<line>:<column>: <message>" for the byte at `at`
+	[[noreturn]] void fail(size_t at, const std::string& message) const;
+	// At the key of the value being read (in onBegin* hooks, the container that just opened)
+	[[noreturn]] void fail(const std::string& message) const;
+
+private:
+	struct Frame {
+		bool is_array = false;
+		std::string key;
+		size_t index = 0;
+		size_t open_offset = 0;
+		size_t key_offset = 0;
+	};
+
+	bool scalar(const json& value);
+	bool open(bool is_array);
+	void close();
+
+	const std::string file_name;
+	std::string_view text;
+	const char* cursor = nullptr; // One past the last byte the parser consumed
+	std::vector<Frame> frames;
+	bool opening = false; // Inside onBeginObject/onBeginArray
+};
+
+#endif // JSONSTREAM_H
@@ -0,0 +1,13 @@
+#include <algorithm>
+
+#include "LevelCurve.h"
+
+int LevelCurve::levelFor(int experience, int current_level) const {
+	int reached = static_cast<int>(std::upper_bound(thresholds.begin(), thresholds.end(), experience) - thresholds.begin());
+	return std::max(current_level, reached);
+}
+
+int LevelCurve::experienceToLeave(int level) const {
+	if (thresholds.empty()) return 0;
+	return thresholds[std::clamp(level, 0, getMaxLevel() - 1)];
+}
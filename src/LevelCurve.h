@@ -0,0 +1,32 @@
+#ifndef LEVELCURVE_H
+#define LEVELCURVE_H
+
+#include <vector>
+
+/* Per-class level curve
+	levels.json lists, for every level from 0 up, the total EXP needed to leave it. The list is dense
+	and never decreases (DataPack checks both), so the curve is a plain sorted array: the level for an
+	EXP total is the number of thresholds at or below it, one binary search no matter how many levels
+	a single gain crosses.
+
+	The top level is one past the last listed entry: reaching the last threshold (80 to leave level 4,
+	say) makes the player level 5, getMaxLevel(), and there is no threshold to leave it.
+*/
+class LevelCurve {
+public:
+	LevelCurve() = default;
+	explicit LevelCurve(std::vector<int> thresholds) : thresholds(std::move(thresholds)) {}
+
+	int getMaxLevel() const { return static_cast<int>(thresholds.size()); }
+
+	// Level reached with `experience` in total, never below `current_level`
+	int levelFor(int experience, int current_level) const;
+
+	// Total EXP needed to leave `level`, the last threshold once at the top (0 for an empty curve)
+	int experienceToLeave(int level) const;
+
+private:
+	std::vector<int> thresholds; // [level] = total EXP needed to reach level + 1
+};
+
+#endif // LEVELCURVE_H
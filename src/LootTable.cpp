@@ -0,0 +1,111 @@
+#include <algorithm>
+#include <cmath>
+
+#include "LootTable.h"
+
+AliasTable::AliasTable(const std::vector<double>& weights) {
+	size_t n = weights.size();
+	double total = 0.0;
+	for (double weight : weights) {
+		if (weight > 0.0) total += weight;
+	}
+	if (n == 0 || total <= 0.0) return; // Nothing can be drawn, empty() tells the caller
+
+	// Vose: scale so the average column is 1, then pair each short column with a long one
+	probability.assign(n, 0.0);
+	alias.assign(n, 0);
+	std::vector<double> scaled(n);
+	std::vector<uint32_t> small, large;
+	small.reserve(n);
+	large.reserve(n);
+	for (size_t i = 0; i < n; i++) {
+		scaled[i] = (weights[i] > 0.0 ? weights[i] : 0.0) * n / total;
+		(scaled[i] < 1.0 ? small : large).push_back(static_cast<uint32_t>(i));
+	}
+	while (!small.empty() && !large.empty()) {
+		uint32_t s = small.back(); small.pop_back();
+		uint32_t l = large.back(); large.pop_back();
+		probability[s] = scaled[s];
+		alias[s] = l;
+		scaled[l] -= 1.0 - scaled[s];
+		(scaled[l] < 1.0 ? small : large).push_back(l);
+	}
+	// Whatever is left is 1 up to rounding error
+	for (uint32_t i : large) {
+		probability[i] = 1.0;
+		alias[i] = i;
+	}
+	uint32_t first_drawable = static_cast<uint32_t>(std::find_if(weights.begin(), weights.end(), [](double w) { return w > 0.0; }) - weights.begin());
+	for (uint32_t i : small) {
+		probability[i] = (weights[i] > 0.0) ? 1.0 : 0.0;
+		alias[i] = (weights[i] > 0.0) ? i : first_drawable;
+	}
+}
+
+size_t AliasTable::sample(double u) const {
+	double scaled = u * probability.size();
+	size_t column = std::min(static_cast<size_t>(scaled), probability.size() - 1);
+	return (scaled - column < probability[column]) ? column : alias[column];
+}
+
+// Last tier whose min_floor is at or below `floor`, tiers are sorted and the first starts at floor 1
+template <typename Tier>
+static const Tier* tierFor(const std::vector<Tier>& tiers, int floor) {
+	auto it = std::upper_bound(tiers.begin(), tiers.end(), floor, [](int f, const Tier& tier) { return f < tier.min_floor; });
+	return (it == tiers.begin()) ? nullptr : &*(it - 1);
+}
+
+bool LootTables::rollRarity(int floor, double u, Rarity& rarity) const {
+	const RarityTier* tier = tierFor(rarity_tiers, floor);
+	if (!tier || tier->rarity.empty()) return false;
+	rarity = static_cast<Rarity>(tier->rarity.sample(u));
+	return true;
+}
+
+/* Picks a band unlocked on `floor` in proportion to its weight, then a template from the band's table.
+	The band is found where `u` lands among the cumulative weights, and where it lands inside the band is
+	rescaled to [0, 1) for the band's own table, so the whole roll still takes a single draw.
+*/
+template <typename CumulativeWeight, typename BandTable>
+static bool rollFromBands(const std::vector<LootTables::TemplateBand>& bands, int floor, double u, CumulativeWeight cumulative, BandTable table_of, uint32_t& template_index) {
+	using Band = LootTables::TemplateBand;
+	auto unlocked_end = std::upper_bound(bands.begin(), bands.end(), floor, [](int f, const Band& band) { return f < band.min_floor; });
+	if (unlocked_end == bands.begin()) return false;
+	double total = cumulative(*(unlocked_end - 1));
+	if (total <= 0.0) return false;
+
+	double target = u * total;
+	auto band = std::upper_bound(bands.begin(), unlocked_end, target, [&cumulative](double t, const Band& b) { return t < cumulative(b); });
+	if (band == unlocked_end) {
+		// u * total rounded up to total, take the last band that has any weight
+		band = std::lower_bound(bands.begin(), unlocked_end, total, [&cumulative](const Band& b, double t) { return cumulative(b) < t; });
+	}
+
+	double below = (band == bands.begin()) ? 0.0 : cumulative(*(band - 1));
+	double within = (target - below) / (cumulative(*band) - below);
+	template_index = table_of(*band).sample(std::min(std::max(within, 0.0), std::nextafter(1.0, 0.0)));
+	return true;
+}
+
+bool LootTables::rollTemplate(int floor, double u, uint32_t& template_index) const {
+	return rollFromBands(template_bands, floor, u,
+		[](const TemplateBand& band) { return band.cumulative_weight; },
+		[](const TemplateBand& band) -> const TemplateTable& { return band.all; },
+		template_index);
+}
+
+bool LootTables::rollTemplate(int floor, EquipmentSlot slot, double u, uint32_t& template_index) const {
+	if (slot == EquipmentSlot::NONE) return false;
+	size_t s = static_cast<size_t>(slot);
+	return rollFromBands(template_bands, floor, u,
+		[s](const TemplateBand& band) { return band.cumulative_slot_weight[s]; },
+		[s](const TemplateBand& band) -> const TemplateTable& { return band.by_slot[s]; },
+		template_index);
+}
+
+bool LootTables::rollBossDrop(int floor, double u, uint32_t& template_index) const {
+	auto it = boss_drops.find(floor);
+	if (it == boss_drops.end() || it->second.empty()) return false;
+	template_index = it->second.sample(u);
+	return true;
+}
@@ -0,0 +1,83 @@
+#ifndef LOOTTABLE_H
+#define LOOTTABLE_H
+
+#include <vector>
+#include <array>
+#include <map>
+#include <cstdint>
+
+#include "Stats.h"
+
+/* Weighted loot tables
+	Every table is built once when the data loads (see Game::loadDataPack) and sampled with Vose's
+	alias method: one uniform draw picks a column, the fractional part decides between the column
+	and its alias. A roll costs the same with 4 templates or 4000.
+
+	Item templates are split into floor bands, one per distinct `min_floor`, and a template only sits
+	in the table of its own band. A template roll picks one of the bands unlocked on the floor by
+	cumulative drop weight (a binary search), then the template with that band's table, both from the
+	same draw. Memory stays O(bands + templates) however many floors unlock new items.
+
+	Data (see DataPack.h for how it is compiled):
+		loot.json    rarity weights per floor tier, a tier applies from its `min_floor` up
+		items.json   optional `drop_weight` (default 1) and `min_floor` (default 1) per template
+		bosses.json  optional `drops` {"item_id": weight} rolled instead of the floor table
+*/
+
+#define RARITY_COUNT 4
+static_assert(RARITY_COUNT == RARITY_NAMES.size(), "RARITY_COUNT counts the values in RARITIES");
+
+// Samples indices [0, n) in proportion to their weights in O(1)
+class AliasTable {
+public:
+	AliasTable() = default;
+	explicit AliasTable(const std::vector<double>& weights); // Zero or negative weights are never drawn
+
+	bool empty() const { return probability.empty(); }
+	size_t size() const { return probability.size(); }
+
+	// `u` is a uniform draw in [0, 1), the caller supplies it so rolls stay on the session's RNG
+	size_t sample(double u) const;
+
+private:
+	std::vector<double> probability; // Chance of keeping the column instead of taking its alias
+	std::vector<uint32_t> alias;
+};
+
+// An alias table over a subset of the item templates
+struct TemplateTable {
+	AliasTable table;
+	std::vector<uint32_t> template_indices; // Table index -> index into GameData::item_templates
+
+	bool empty() const { return table.empty(); }
+	uint32_t sample(double u) const { return template_indices[table.sample(u)]; }
+};
+
+struct LootTables {
+	// Rarity weights that apply from `min_floor` up, sorted by min_floor, the first one starts at floor 1
+	struct RarityTier {
+		int min_floor = 1;
+		AliasTable rarity; // Indexed by Rarity
+	};
+	// Templates whose min_floor is exactly `min_floor`, sorted by min_floor
+	struct TemplateBand {
+		int min_floor = 1;
+		TemplateTable all;
+		std::array<TemplateTable, TOTAL_NUMBER_OF_SLOTS> by_slot;
+		// Drop weight of this band plus every band before it, what the band is picked by
+		double cumulative_weight = 0.0;
+		std::array<double, TOTAL_NUMBER_OF_SLOTS> cumulative_slot_weight{};
+	};
+
+	std::vector<RarityTier> rarity_tiers;
+	std::vector<TemplateBand> template_bands;
+	std::map<int, TemplateTable> boss_drops; // Floor -> the boss's own table
+
+	// Each returns false when nothing can drop. `u` is a uniform draw in [0, 1).
+	bool rollRarity(int floor, double u, Rarity& rarity) const;
+	bool rollTemplate(int floor, double u, uint32_t& template_index) const;
+	bool rollTemplate(int floor, EquipmentSlot slot, double u, uint32_t& template_index) const;
+	bool rollBossDrop(int floor, double u, uint32_t& template_index) const;
+};
+
+#endif // LOOTTABLE_H
@@ -0,0 +1,34 @@
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "MappedFile.h"
+
+bool mapFile(const std::string& file_path, MappedFile& mapped) {
+	int fd = open(file_path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0) return false;
+
+	struct stat file_stat{};
+	if (fstat(fd, &file_stat) != 0) {
+		close(fd);
+		return false;
+	}
+	mapped.modified = file_stat.st_mtime;
+
+	size_t size = static_cast<size_t>(file_stat.st_size);
+	if (size == 0) {
+		close(fd);
+		mapped.mapping.reset();
+		mapped.contents = std::string_view();
+		return true;
+	}
+
+	void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd); // The mapping stays valid without the descriptor
+	if (data == MAP_FAILED) return false;
+
+	mapped.mapping = std::shared_ptr<const void>(data, [size](const void* p) { munmap(const_cast<void*>(p), size); });
+	mapped.contents = std::string_view(static_cast<const char*>(data), size);
+	return true;
+}
@@ -0,0 +1,20 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <string>
+#include <string_view>
+#include <memory>
+#include <ctime>
+
+// A whole file mapped read-only. `contents` stays valid while anything holds a copy of `mapping`.
+struct MappedFile {
+	std::shared_ptr<const void> mapping; // Unmaps when the last holder is gone
+	std::string_view contents;
+	time_t modified = 0;
+};
+
+// Maps `file_path`, returns false if it can't be opened or mapped.
+// Empty files get an empty view and no mapping, mmap rejects zero lengths.
+bool mapFile(const std::string& file_path, MappedFile& mapped);
+
+#endif // MAPPEDFILE_H
@@ -1,12 +1,14 @@
 #include <iostream>
 #include <algorithm>
 #include <utility>
+#include <climits>
 
 #include "Mech.h"
+#include "StringInterner.h"
 
 // Constructor: Parameterized for creating mechs with initial stats.
-Mech::Mech(std::string n, Stats base) {
-	name = n;
+Mech::Mech(std::string_view n, Stats base) {
+	name = internName(n);
 	base_stats = base;
 	equipment = std::make_unique<Equipment>(); // RAII empty equipment
 	resetCombatState();
@@ -14,7 +16,7 @@ Mech::Mech(std::string n, Stats base) {
 }
 
 // --- Getters ---
-std::string Mech::getName() const {
+std::string_view Mech::getName() const {
 	return name;
 }
 
@@ -35,14 +37,24 @@ double Mech::getCurrentEnergy() const {
 }
 
 // --- Setters ---
-void Mech::setName(const std::string& n) {
-	this->name = n;
+void Mech::setName(std::string_view n) {
+	this->name = internName(n);
 }
 
 void Mech::setBaseStats(const Stats& s) {
 	this->base_stats = s;
 }
 
+void Mech::restoreProgress(int saved_level, int saved_exp) {
+	level = saved_level;
+	current_exp = saved_exp;
+}
+
+void Mech::setCombatState(double hp, double energy_shield) {
+	current_hp = std::max(0.0, hp);
+	current_energy_shield = std::max(0.0, energy_shield);
+}
+
 // Returns a reference to the Equipment Manager
 // the unique_ptr 'equipment' should have been initialized by constructors
 Equipment& Mech::getEquipment() {
@@ -144,7 +156,7 @@ void Mech::takeDamage(double incoming_damage) {
 		current_hp = 0;
 	}
 
-	std::cout << getName() + " after damage HP: " + std::to_string(getCurrentHp()) + " EN_SHIELD: " + std::to_string(getCurrentEnergyShield()) << std::endl; 
+	std::cout << getName() << " after damage HP: " << std::to_string(getCurrentHp()) << " EN_SHIELD: " << std::to_string(getCurrentEnergyShield()) << std::endl;
 }
 
 // Regenerates health and energy over time
@@ -247,14 +259,14 @@ void Mech::printCurrentEquipment() const {
 }
 
 // handles adding experience to the current player state
-void Mech::addExperience(int amount, std::map<std::string, std::map<int, int>> level_requirements, std::string pc_id) {
-	current_exp += amount;
-	std::map<int, int> class_requirements = level_requirements[pc_id];
-	int new_level = getLevel();
-
-	if (current_exp >= class_requirements[getLevel()]) {
-		std::cout << "LEVEL UP!!!" << std::endl;
-		level = new_level + 1;
+void Mech::addExperience(int amount, const LevelCurve& curve) {
+	// Offline catch-up can grant more than an int holds, the total saturates instead of wrapping
+	current_exp = static_cast<int>(std::min<long long>(INT_MAX, static_cast<long long>(current_exp) + std::max(0, amount)));
+
+	int new_level = curve.levelFor(current_exp, level);
+	if (new_level > level) {
+		std::cout << "LEVEL UP!!! " << level << " -> " << new_level << std::endl;
+		level = new_level;
 
 		// TODO(MSR): trigger stat allocation points being given to player 
 	}
@@ -2,18 +2,19 @@
 #define MECH_H
 
 #include <string>
+#include <string_view>
 #include <memory>
 #include <map>
 #include "Stats.h"
 #include "Equipment.h"
-#include "GameClasses.h"
+#include "LevelCurve.h"
 
 class Mech {
 public:
-	Mech(std::string n, Stats base);
+	Mech(std::string_view n, Stats base);
 	Mech() = default; // Needed for placeholder enemy
 
-	std::string getName() const;
+	std::string_view getName() const; // Interned, see StringInterner.h
 	const Stats& getBaseStats() const;
 	Stats getTotalStats() const; // Combines base + equipment
 	Equipment& getEquipment(); // Non-const access to manage equipment
@@ -34,8 +35,9 @@ public:
 	// Placeholder for Tech requirement check later
 	bool canEquip(const Item& item) const;
 
-	void setName(const std::string& n); // For bosses/enemies
+	void setName(std::string_view n); // For bosses/enemies, no allocation for a name that is already interned
 	void setBaseStats(const Stats& s); // For bosses/enemies
+	void setCombatState(double hp, double energy_shield); // Used when a fight is resolved without stepping it
 
 	// Print current equipment
 	void printCurrentEquipment() const;
@@ -52,12 +54,13 @@ public:
 	const std::vector<std::shared_ptr<Item>>& getInventory() const;
 
 	// Experience methods
-	void addExperience(int amount, std::map<std::string, std::map<int, int>> level_requirements, std::string pc_id);
+	void addExperience(int amount, const LevelCurve& curve); // Applies every level-up the new total reaches
 	int getCurrentExperience() const { return current_exp; }
 	int getLevel() const { return level; }
+	void restoreProgress(int saved_level, int saved_exp); // Used when loading a save
 
 private:
-	std::string name;
+	std::string_view name;
 	Stats base_stats;
 	std::unique_ptr<Equipment> equipment; // Using unique_ptr for ownership
 
@@ -0,0 +1,37 @@
+#include <iostream>
+#include <stdexcept>
+#include <ctime>
+
+#include "PageCache.h"
+
+void PageCache::compile(const AssetCache& assets, const std::string& name) {
+	const CachedAsset* source = assets.find(name);
+	if (!source) {
+		throw std::runtime_error("PageCache: template not found in asset cache: " + name);
+	}
+
+	templates.erase(name);
+	templates.emplace(name, crow::mustache::compile(std::string(source->identity)));
+	std::cout << "PageCache: compiled " << name << std::endl;
+}
+
+void PageCache::prerender(const std::string& name, const crow::mustache::context& ctx) {
+	const crow::mustache::template_t* tpl = getTemplate(name);
+	if (!tpl) {
+		throw std::runtime_error("PageCache: template not compiled: " + name);
+	}
+
+	std::string body = tpl->render(ctx).dump();
+	pages[name] = AssetCache::makeAsset(name, std::move(body), std::time(nullptr));
+	std::cout << "PageCache: prerendered " << name << " (" << pages[name].identity.size() << " bytes)" << std::endl;
+}
+
+const crow::mustache::template_t* PageCache::getTemplate(const std::string& name) const {
+	auto it = templates.find(name);
+	return (it != templates.end()) ? &it->second : nullptr;
+}
+
+const CachedAsset* PageCache::getPage(const std::string& name) const {
+	auto it = pages.find(name);
+	return (it != pages.end()) ? &it->second : nullptr;
+}
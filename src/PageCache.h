@@ -0,0 +1,35 @@
+#ifndef PAGECACHE_H
+#define PAGECACHE_H
+
+#include <string>
+#include <unordered_map>
+
+#include "crow_all.h"
+#include "AssetCache.h"
+
+/* Compiled and pre-rendered mustache pages
+	Templates are compiled once from the AssetCache's in-memory copy of the file, so neither
+	compiling nor rendering touches the disk. Pages whose output doesn't depend on the request
+	are rendered once and kept as a CachedAsset, which gives them the same ETag/304 and
+	precompressed variants as the static assets.
+
+	NOTE(MSR): Partials ({{>name}}) would still go through crow's file loader at render time.
+	None of the pages use them today.
+*/
+class PageCache {
+public:
+	// Compiles `name` (path relative to the web root). Throws std::runtime_error if it isn't cached.
+	void compile(const AssetCache& assets, const std::string& name);
+
+	// Renders a compiled template against `ctx` once and keeps the bytes
+	void prerender(const std::string& name, const crow::mustache::context& ctx);
+
+	const crow::mustache::template_t* getTemplate(const std::string& name) const;
+	const CachedAsset* getPage(const std::string& name) const; // nullptr if not prerendered
+
+private:
+	std::unordered_map<std::string, crow::mustache::template_t> templates;
+	std::unordered_map<std::string, CachedAsset> pages;
+};
+
+#endif // PAGECACHE_H
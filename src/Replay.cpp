@@ -0,0 +1,95 @@
+#include <stdexcept>
+
+#include "Replay.h"
+#include "json.hpp"
+
+using json = nlohmann::json;
+
+namespace {
+
+const char* commandTypeToString(ReplayCommandType type) {
+	switch (type) {
+		case ReplayCommandType::SELECT_CLASS: return "select_class";
+		case ReplayCommandType::START_GAME: return "start";
+		case ReplayCommandType::EQUIP: return "equip";
+		case ReplayCommandType::OBSERVED: return "observed";
+		case ReplayCommandType::STOP: return "stop";
+	}
+	return "stop";
+}
+
+ReplayCommandType stringToCommandType(const std::string& s) {
+	if (s == "select_class") return ReplayCommandType::SELECT_CLASS;
+	if (s == "start") return ReplayCommandType::START_GAME;
+	if (s == "equip") return ReplayCommandType::EQUIP;
+	if (s == "observed") return ReplayCommandType::OBSERVED;
+	if (s == "stop") return ReplayCommandType::STOP;
+	throw std::runtime_error("Unknown replay command: " + s);
+}
+
+} // namespace
+
+bool ReplayRecorder::open(const std::string& path, unsigned int seed) {
+	out.open(path, std::ios::out | std::ios::trunc);
+	if (!out.is_open()) {
+		return false;
+	}
+	json header = {{"version", REPLAY_FORMAT_VERSION}, {"seed", seed}};
+	out << header.dump() << "\n";
+	out.flush();
+	return true;
+}
+
+void ReplayRecorder::record(const ReplayCommand& command) {
+	if (!out.is_open()) return;
+
+	json line = {{"tick", command.tick}, {"cmd", commandTypeToString(command.type)}};
+	if (command.type == ReplayCommandType::SELECT_CLASS) line["class"] = command.class_id;
+	if (command.type == ReplayCommandType::EQUIP) line["index"] = command.index;
+	if (command.type == ReplayCommandType::OBSERVED) line["value"] = command.observed;
+
+	out << line.dump() << "\n";
+	out.flush();
+}
+
+ReplayLog loadReplayLog(const std::string& path) {
+	std::ifstream in(path);
+	if (!in.is_open()) {
+		throw std::runtime_error("Failed to open replay file: " + path);
+	}
+
+	ReplayLog log;
+	std::string line;
+	int line_number = 0;
+	try {
+		while (std::getline(in, line)) {
+			line_number++;
+			if (line.empty()) continue;
+			json entry = json::parse(line);
+
+			if (line_number == 1) {
+				int version = entry.at("version").get<int>();
+				if (version != REPLAY_FORMAT_VERSION) {
+					throw std::runtime_error("Unsupported replay version " + std::to_string(version));
+				}
+				log.seed = entry.at("seed").get<unsigned int>();
+				continue;
+			}
+
+			ReplayCommand command;
+			command.tick = entry.at("tick").get<uint64_t>();
+			command.type = stringToCommandType(entry.at("cmd").get<std::string>());
+			command.class_id = entry.value("class", "");
+			command.index = entry.value("index", 0);
+			command.observed = entry.value("value", false);
+			log.commands.push_back(command);
+		}
+	} catch (const json::exception& e) {
+		throw std::runtime_error("Malformed replay file " + path + " at line " + std::to_string(line_number) + ": " + e.what());
+	}
+
+	if (line_number == 0) {
+		throw std::runtime_error("Empty replay file: " + path);
+	}
+	return log;
+}
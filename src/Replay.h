@@ -0,0 +1,61 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdint>
+
+/* Deterministic session recording
+	The simulation is a pure function of the RNG seed and the player's commands once the game
+	loop runs on a fixed timestep, so a session can be reproduced from:
+		- the seed the Game was created with
+		- every command, stamped with the number of ticks completed when it was applied
+
+	File format: JSON lines. The first line is the header, every following line is a command.
+		{"version": 1, "seed": 1234}
+		{"tick": 0, "cmd": "select_class", "class": "ace"}
+		{"tick": 0, "cmd": "start"}
+		{"tick": 812, "cmd": "observed", "value": true}
+		{"tick": 9120, "cmd": "equip", "index": 3}
+		{"tick": 40000, "cmd": "stop"}
+*/
+
+#define REPLAY_FORMAT_VERSION 4 // v4: the loot RNG is reseeded with the start tick mixed in (Game::loopSeed). v3: floors past bosses.json get generated bosses (BossGenerator.h). v2: loot is rolled from alias tables (LootTable.h).
+
+enum class ReplayCommandType {
+	SELECT_CLASS,
+	START_GAME,
+	EQUIP,
+	OBSERVED, // A client started/stopped polling, this changes how fights are resolved
+	STOP
+};
+
+struct ReplayCommand {
+	uint64_t tick = 0;
+	ReplayCommandType type = ReplayCommandType::STOP;
+	std::string class_id; // SELECT_CLASS
+	int index = 0;        // EQUIP
+	bool observed = false; // OBSERVED
+};
+
+struct ReplayLog {
+	unsigned int seed = 0;
+	std::vector<ReplayCommand> commands;
+};
+
+// Appends commands to a recording file as they happen, flushed line by line so a crash keeps them
+class ReplayRecorder {
+public:
+	bool open(const std::string& path, unsigned int seed);
+	bool isOpen() const { return out.is_open(); }
+	void record(const ReplayCommand& command);
+
+private:
+	std::ofstream out;
+};
+
+// Throws std::runtime_error if the file can't be read or is malformed
+ReplayLog loadReplayLog(const std::string& path);
+
+#endif // REPLAY_H
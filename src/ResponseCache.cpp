@@ -0,0 +1,39 @@
+#include "ResponseCache.h"
+
+std::shared_ptr<CachedResponse> ResponseCache::get(uint64_t version, const std::function<std::string()>& build) {
+	// Held while building so concurrent pollers of a new version wait for one build instead of each doing it
+	std::lock_guard<std::mutex> lock(mutex);
+	if (current && current->version == version) {
+		return current;
+	}
+
+	auto response = std::make_shared<CachedResponse>();
+	response->version = version;
+	response->identity = build();
+	current = response;
+	return response;
+}
+
+std::string_view ResponseCache::selectVariant(CachedResponse& response, const std::string& accept_encoding, ContentEncoding& encoding) {
+	encoding = ContentEncoding::IDENTITY;
+	if (response.identity.size() < DYNAMIC_COMPRESSION_MIN_BYTES) {
+		return response.identity;
+	}
+
+	// gzip first, some old clients mishandle "deflate" (raw vs zlib-wrapped)
+	if (acceptsEncoding(accept_encoding, "gzip")) {
+		std::call_once(response.gzip_once, [&response]() {
+			response.gzip = gzipCompress(response.identity, DYNAMIC_COMPRESSION_LEVEL);
+		});
+		encoding = ContentEncoding::GZIP;
+		return response.gzip;
+	}
+	if (acceptsEncoding(accept_encoding, "deflate")) {
+		std::call_once(response.deflate_once, [&response]() {
+			response.deflate = deflateCompress(response.identity, DYNAMIC_COMPRESSION_LEVEL);
+		});
+		encoding = ContentEncoding::DEFLATE;
+		return response.deflate;
+	}
+	return response.identity;
+}
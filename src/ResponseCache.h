@@ -0,0 +1,48 @@
+#ifndef RESPONSECACHE_H
+#define RESPONSECACHE_H
+
+#include <string>
+#include <string_view>
+#include <memory>
+#include <mutex>
+#include <functional>
+#include <cstdint>
+
+#include "Compression.h"
+
+/* Cache for one dynamic response, keyed by a version number
+	Every client polls /api/gamestate, but the game only changes once per tick. The body is built
+	the first time a version is asked for and shared by every request until the version moves on.
+	Compressed variants are produced lazily, at most once per version and encoding.
+
+	Bodies smaller than DYNAMIC_COMPRESSION_MIN_BYTES are always sent as-is, there the headers
+	and the CPU cost outweigh the bytes saved.
+*/
+
+#define DYNAMIC_COMPRESSION_MIN_BYTES 1024
+#define DYNAMIC_COMPRESSION_LEVEL 6 // zlib's default, level 9 costs far more for a few percent on small JSON
+
+struct CachedResponse {
+	uint64_t version = 0;
+	std::string identity;
+
+	std::string gzip;
+	std::string deflate;
+	std::once_flag gzip_once;
+	std::once_flag deflate_once;
+};
+
+class ResponseCache {
+public:
+	// Returns the response for `version`, calling `build` only if it isn't cached yet
+	std::shared_ptr<CachedResponse> get(uint64_t version, const std::function<std::string()>& build);
+
+	// Picks gzip or deflate if the client accepts it and the body is worth compressing
+	static std::string_view selectVariant(CachedResponse& response, const std::string& accept_encoding, ContentEncoding& encoding);
+
+private:
+	std::mutex mutex;
+	std::shared_ptr<CachedResponse> current; // Requests still holding the previous version keep it alive
+};
+
+#endif // RESPONSECACHE_H
@@ -0,0 +1,213 @@
+#include <stdexcept>
+#include <cstring>
+#include <cerrno>
+#include <filesystem>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "SaveGame.h"
+#include "MappedFile.h"
+#include "BinaryIO.h"
+
+namespace {
+
+const char SAVE_MAGIC[4] = {'I', 'M', 'S', 'V'};
+const size_t SAVE_HEADER_SIZE = 24;
+
+enum SaveSection : uint16_t {
+	SECTION_SESSION = 1,   // pilot class, seed, tick count, journal sequence (v2)
+	SECTION_PROGRESS = 2,  // floor, enemies defeated
+	SECTION_PLAYER = 3,    // name, base stats, level, EXP
+	SECTION_EQUIPMENT = 4, // equipped items with their slot
+	SECTION_INVENTORY = 5  // unequipped items
+};
+
+// Writes a section header with a placeholder length, patched by endSection
+size_t beginSection(ByteWriter& writer, SaveSection tag) {
+	writer.u16(tag);
+	writer.u16(0);
+	return writer.placeholderU32();
+}
+
+void endSection(ByteWriter& writer, size_t length_pos) {
+	writer.patchU32(length_pos, static_cast<uint32_t>(writer.size() - length_pos - 4));
+}
+
+} // namespace
+
+std::string encodeSnapshot(const SaveSnapshot& snapshot) {
+	std::string out;
+	out.reserve(SAVE_HEADER_SIZE + 128 + (snapshot.equipment.size() + snapshot.inventory.size()) * 128);
+	ByteWriter writer(out);
+
+	// Header, payload size and checksum are patched in once the payload is written
+	out.append(SAVE_MAGIC, sizeof(SAVE_MAGIC));
+	writer.u16(SAVE_FORMAT_VERSION);
+	writer.u16(SAVE_MIN_READER_VERSION);
+	writer.u32(5); // section_count
+	size_t payload_size_pos = writer.placeholderU32();
+	size_t checksum_pos = writer.placeholderU32();
+	writer.u32(0); // reserved
+
+	size_t section = beginSection(writer, SECTION_SESSION);
+	writer.str(snapshot.pilot_class_id);
+	writer.u32(snapshot.rng_seed);
+	writer.u64(snapshot.tick_count);
+	writer.u64(snapshot.journal_sequence);
+	endSection(writer, section);
+
+	section = beginSection(writer, SECTION_PROGRESS);
+	writer.i32(snapshot.current_floor);
+	writer.i32(snapshot.enemies_defeated_on_floor);
+	endSection(writer, section);
+
+	section = beginSection(writer, SECTION_PLAYER);
+	writer.str(snapshot.player_name);
+	writer.stats(snapshot.player_base_stats);
+	writer.i32(snapshot.player_level);
+	writer.i32(snapshot.player_experience);
+	endSection(writer, section);
+
+	section = beginSection(writer, SECTION_EQUIPMENT);
+	writer.u32(static_cast<uint32_t>(snapshot.equipment.size()));
+	for (const auto& [slot, item] : snapshot.equipment) {
+		writer.u8(static_cast<uint8_t>(slot));
+		writer.item(item);
+	}
+	endSection(writer, section);
+
+	section = beginSection(writer, SECTION_INVENTORY);
+	writer.u32(static_cast<uint32_t>(snapshot.inventory.size()));
+	for (const SavedItem& item : snapshot.inventory) {
+		writer.item(item);
+	}
+	endSection(writer, section);
+
+	std::string_view payload(out.data() + SAVE_HEADER_SIZE, out.size() - SAVE_HEADER_SIZE);
+	writer.patchU32(payload_size_pos, static_cast<uint32_t>(payload.size()));
+	writer.patchU32(checksum_pos, checksum32(payload));
+	return out;
+}
+
+SaveSnapshot decodeSnapshot(std::string_view bytes) {
+	if (bytes.size() < SAVE_HEADER_SIZE || bytes.compare(0, sizeof(SAVE_MAGIC), std::string_view(SAVE_MAGIC, sizeof(SAVE_MAGIC))) != 0) {
+		throw std::runtime_error("SaveGame: not a save file");
+	}
+
+	ByteReader header(bytes.substr(sizeof(SAVE_MAGIC), SAVE_HEADER_SIZE - sizeof(SAVE_MAGIC)));
+	uint16_t format_version = header.u16();
+	uint16_t min_reader_version = header.u16();
+	uint32_t section_count = header.u32();
+	uint32_t payload_size = header.u32();
+	uint32_t checksum = header.u32();
+
+	if (min_reader_version > SAVE_FORMAT_VERSION) {
+		throw std::runtime_error("SaveGame: save format " + std::to_string(format_version) + " needs a newer server (this one reads up to " + std::to_string(SAVE_FORMAT_VERSION) + ")");
+	}
+	if (payload_size != bytes.size() - SAVE_HEADER_SIZE) {
+		throw std::runtime_error("SaveGame: snapshot is truncated");
+	}
+	std::string_view payload = bytes.substr(SAVE_HEADER_SIZE);
+	if (checksum32(payload) != checksum) {
+		throw std::runtime_error("SaveGame: checksum mismatch");
+	}
+
+	SaveSnapshot snapshot;
+	ByteReader sections(payload);
+	for (uint32_t i = 0; i < section_count; i++) {
+		uint16_t tag = sections.u16();
+		sections.u16(); // reserved
+		uint32_t length = sections.u32();
+		ByteReader reader(sections.bytes(length));
+
+		// Fields a later format appends to a section must be read behind `if (!reader.atEnd())`
+		switch (tag) {
+			case SECTION_SESSION:
+				snapshot.pilot_class_id = reader.str();
+				snapshot.rng_seed = reader.u32();
+				snapshot.tick_count = reader.u64();
+				if (!reader.atEnd()) snapshot.journal_sequence = reader.u64();
+				break;
+			case SECTION_PROGRESS:
+				snapshot.current_floor = reader.i32();
+				snapshot.enemies_defeated_on_floor = reader.i32();
+				break;
+			case SECTION_PLAYER:
+				snapshot.player_name = reader.str();
+				snapshot.player_base_stats = reader.stats();
+				snapshot.player_level = reader.i32();
+				snapshot.player_experience = reader.i32();
+				break;
+			case SECTION_EQUIPMENT: {
+				uint32_t count = reader.u32();
+				for (uint32_t n = 0; n < count; n++) {
+					uint8_t slot = reader.u8();
+					SavedItem item = reader.item();
+					if (slot <= LAST_EQUIPMENT_SLOT) {
+						snapshot.equipment.emplace_back(static_cast<EquipmentSlot>(slot), std::move(item));
+					} else {
+						snapshot.inventory.push_back(std::move(item)); // Slot from a newer build, keep the item at least
+					}
+				}
+				break;
+			}
+			case SECTION_INVENTORY: {
+				uint32_t count = reader.u32();
+				snapshot.inventory.reserve(snapshot.inventory.size() + count);
+				for (uint32_t n = 0; n < count; n++) {
+					snapshot.inventory.push_back(reader.item());
+				}
+				break;
+			}
+			default:
+				break; // Section from a newer build
+		}
+	}
+	return snapshot;
+}
+
+void writeSnapshotFile(const std::string& path, const std::string& encoded) {
+	std::string tmp_path = path + ".tmp";
+	int fd = open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if (fd < 0) {
+		throw std::runtime_error("SaveGame: failed to open " + tmp_path + ": " + std::strerror(errno));
+	}
+	try {
+		writeAll(fd, encoded, tmp_path);
+		if (fsync(fd) != 0) {
+			throw std::runtime_error("SaveGame: failed to fsync " + tmp_path + ": " + std::strerror(errno));
+		}
+	} catch (...) {
+		close(fd);
+		unlink(tmp_path.c_str());
+		throw;
+	}
+	close(fd);
+
+	if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+		int error = errno;
+		unlink(tmp_path.c_str());
+		throw std::runtime_error("SaveGame: failed to rename " + tmp_path + ": " + std::strerror(error));
+	}
+
+	// Make the rename itself durable
+	std::string dir = std::filesystem::path(path).parent_path().string();
+	int dir_fd = open(dir.empty() ? "." : dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+	if (dir_fd >= 0) {
+		fsync(dir_fd);
+		close(dir_fd);
+	}
+}
+
+SaveSnapshot loadSnapshotFile(const std::string& path) {
+	MappedFile mapped;
+	if (!mapFile(path, mapped)) {
+		throw std::runtime_error("SaveGame: failed to open " + path);
+	}
+	try {
+		return decodeSnapshot(mapped.contents);
+	} catch (const std::runtime_error& e) {
+		throw std::runtime_error(std::string(e.what()) + " (" + path + ")");
+	}
+}
@@ -0,0 +1,73 @@
+#ifndef SAVEGAME_H
+#define SAVEGAME_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+#include "Stats.h"
+
+/* Binary save-game snapshots
+	A snapshot is a plain copy of everything a session needs to resume: pilot class, floor progress,
+	player level/EXP and every equipped and inventory item (template id, rarity, rolled stats).
+	It holds no pointers into the live game, so it can be encoded away from `game_state_mutex`.
+
+	File layout, all integers little-endian:
+		header   "IMSV" | u16 format_version | u16 min_reader_version | u32 section_count | u32 payload_size | u32 crc32(payload) | u32 reserved
+		payload  section_count x ( u16 tag | u16 reserved | u32 length | `length` bytes )
+
+	Compatibility rules, so old and new servers can share saves:
+		- Readers skip sections with unknown tags.
+		- Fields are only ever appended to the end of a section. A reader stops at the section's
+		  length, so it ignores newer trailing fields, and fields missing from older saves keep the
+		  defaults in SaveSnapshot.
+		- Anything an older reader would get wrong bumps `min_reader_version`. Readers refuse files
+		  whose min_reader_version is newer than SAVE_FORMAT_VERSION.
+		- Stats and slots are stored by enum value. Unknown stats are dropped, items in unknown slots
+		  are restored into the inventory.
+*/
+
+#define SAVE_FORMAT_VERSION 2 // v2: journal sequence appended to the session section
+#define SAVE_MIN_READER_VERSION 1 // Oldest reader that can load what this build writes
+
+struct SavedItem {
+	std::string template_id;
+	Rarity rarity = Rarity::COMMON;
+	Stats stats; // Rolled instance stats, not the template's
+};
+
+struct SaveSnapshot {
+	// Session
+	std::string pilot_class_id;
+	unsigned int rng_seed = 0;
+	uint64_t tick_count = 0;
+	uint64_t journal_sequence = 0; // Last journal event already folded into this snapshot (see Journal.h)
+
+	// Progress
+	int current_floor = 1;
+	int enemies_defeated_on_floor = 0;
+
+	// Player mech
+	std::string player_name;
+	Stats player_base_stats;
+	int player_level = 0;
+	int player_experience = 0;
+	std::vector<std::pair<EquipmentSlot, SavedItem>> equipment;
+	std::vector<SavedItem> inventory;
+};
+
+// Serializes a snapshot (header included)
+std::string encodeSnapshot(const SaveSnapshot& snapshot);
+
+// Parses an encoded snapshot. Throws std::runtime_error on a bad magic, checksum, version or truncation.
+SaveSnapshot decodeSnapshot(std::string_view bytes);
+
+// Writes atomically: to `<path>.tmp`, fsync, then rename over `path`. Throws std::runtime_error on failure.
+void writeSnapshotFile(const std::string& path, const std::string& encoded);
+
+// Maps the file and decodes it without reading it into a buffer first. Throws std::runtime_error on failure.
+SaveSnapshot loadSnapshotFile(const std::string& path);
+
+#endif // SAVEGAME_H
@@ -0,0 +1,74 @@
+#include <iostream>
+
+#include "SaveWorker.h"
+
+SaveWorker::~SaveWorker() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	work_available.notify_all();
+	if (thread.joinable()) {
+		thread.join();
+	}
+}
+
+void SaveWorker::start() {
+	std::lock_guard<std::mutex> lock(mutex);
+	if (running) return;
+	running = true;
+	thread = std::thread(&SaveWorker::run, this);
+}
+
+void SaveWorker::submit(const std::string& key, std::function<void()> job) {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		auto it = jobs.find(key);
+		if (it != jobs.end()) {
+			it->second = std::move(job); // Keeps its place in the queue, only the newest state gets written
+			coalesced++;
+		} else {
+			jobs.emplace(key, std::move(job));
+			order.push_back(key);
+		}
+	}
+	work_available.notify_one();
+}
+
+void SaveWorker::waitIdle() {
+	std::unique_lock<std::mutex> lock(mutex);
+	if (!running) return;
+	idle.wait(lock, [this]() { return order.empty() && !busy; });
+}
+
+size_t SaveWorker::getCoalescedCount() {
+	std::lock_guard<std::mutex> lock(mutex);
+	return coalesced;
+}
+
+void SaveWorker::run() {
+	std::unique_lock<std::mutex> lock(mutex);
+	while (true) {
+		work_available.wait(lock, [this]() { return stopping || !order.empty(); });
+		if (order.empty()) break; // Stopping with nothing left to do
+
+		std::string key = std::move(order.front());
+		order.pop_front();
+		std::function<void()> job = std::move(jobs[key]);
+		jobs.erase(key);
+		busy = true;
+
+		lock.unlock();
+		try {
+			job();
+		} catch (const std::exception& e) {
+			std::cerr << "SaveWorker: job '" << key << "' failed: " << e.what() << std::endl;
+		}
+		job = nullptr; // Release captured state before reporting idle
+		lock.lock();
+
+		busy = false;
+		if (order.empty()) idle.notify_all();
+	}
+	idle.notify_all();
+}
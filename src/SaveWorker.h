@@ -0,0 +1,48 @@
+#ifndef SAVEWORKER_H
+#define SAVEWORKER_H
+
+#include <string>
+#include <deque>
+#include <unordered_map>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+/* Background thread for save I/O
+	Encoding, writing and fsyncing saves happen here instead of on the game thread, so a slow disk
+	never lengthens a tick or holds `game_state_mutex`. Jobs are keyed (by save path, journal, ...):
+	submitting under a key whose previous job hasn't started yet replaces that job, so a burst of
+	saves for one session costs a single write of its latest state.
+*/
+
+class SaveWorker {
+public:
+	~SaveWorker(); // Runs whatever is still queued, then joins
+
+	void start(); // Idempotent
+
+	// Queues `job` under `key`, replacing a job with the same key that is still waiting
+	void submit(const std::string& key, std::function<void()> job);
+
+	// Blocks until every job submitted so far has finished
+	void waitIdle();
+
+	size_t getCoalescedCount(); // Jobs dropped because a newer one with the same key replaced them
+
+private:
+	void run();
+
+	std::thread thread;
+	std::mutex mutex;
+	std::condition_variable work_available;
+	std::condition_variable idle;
+	std::deque<std::string> order; // Keys in submission order, each appears once
+	std::unordered_map<std::string, std::function<void()>> jobs;
+	bool running = false;
+	bool stopping = false;
+	bool busy = false;
+	size_t coalesced = 0;
+};
+
+#endif // SAVEWORKER_H
@@ -3,13 +3,30 @@
 
 #include <map>
 #include <string>
+#include <string_view>
+#include <stdexcept>
+
+#include "EnumTable.h"
 
 #define TOTAL_NUMBER_OF_SLOTS 9
 
+// Each list expands to the enum and to its name table (see EnumTable.h), the names are what the data files use
+#define STAT_TYPES(X) \
+	X(HEALTH) X(ARMOR) X(ENERGY_SHIELD) X(ATTACK) \
+	X(ATTACK_SPEED) X(MOBILITY) X(ENERGY) X(ENERGY_RECOVERY) \
+	X(REPAIR) X(TECHNOLOGY)
+
+#define EQUIPMENT_SLOTS(X) \
+	X(HEAD) X(CHEST) X(ARMS) X(LEGS) X(GENERATOR) \
+	X(LEFT_ARM_WEAPON) X(RIGHT_ARM_WEAPON) \
+	X(LEFT_SHOULDER_WEAPON) X(RIGHT_SHOULDER_WEAPON) \
+	X(NONE)
+
+#define RARITIES(X) \
+	X(COMMON) X(UNCOMMON) X(RARE) X(LEGENDARY)
+
 enum class StatType {
-	HEALTH, ARMOR, ENERGY_SHIELD, ATTACK,
-	ATTACK_SPEED, MOBILITY, ENERGY, ENERGY_RECOVERY,
-	REPAIR, TECHNOLOGY
+	STAT_TYPES(ENUM_TABLE_VALUE)
 };
 
 // Using a map for flexibility, though a struct could be faster if stats are fixed
@@ -27,15 +44,39 @@ inline void addStat(Stats& stats, StatType type, double value) {
 }
 
 enum class EquipmentSlot {
-	HEAD, CHEST, ARMS, LEGS, GENERATOR,
-	LEFT_ARM_WEAPON, RIGHT_ARM_WEAPON,
-	LEFT_SHOULDER_WEAPON, RIGHT_SHOULDER_WEAPON,
-	NONE
+	EQUIPMENT_SLOTS(ENUM_TABLE_VALUE)
 };
 
 enum class Rarity {
-	COMMON, UNCOMMON, RARE, LEGENDARY
+	RARITIES(ENUM_TABLE_VALUE)
 };
 
+inline constexpr std::string_view STAT_TYPE_NAME_LIST[] = {STAT_TYPES(ENUM_TABLE_NAME)};
+inline constexpr std::string_view EQUIPMENT_SLOT_NAME_LIST[] = {EQUIPMENT_SLOTS(ENUM_TABLE_NAME)};
+inline constexpr std::string_view RARITY_NAME_LIST[] = {RARITIES(ENUM_TABLE_NAME)};
+
+inline constexpr auto STAT_TYPE_NAMES = makeEnumTable<StatType>(STAT_TYPE_NAME_LIST);
+inline constexpr auto EQUIPMENT_SLOT_NAMES = makeEnumTable<EquipmentSlot>(EQUIPMENT_SLOT_NAME_LIST);
+inline constexpr auto RARITY_NAMES = makeEnumTable<Rarity>(RARITY_NAME_LIST);
+
+static_assert(static_cast<size_t>(EquipmentSlot::NONE) + 1 == EQUIPMENT_SLOT_NAMES.size(), "NONE must stay the last equipment slot");
+static_assert(TOTAL_NUMBER_OF_SLOTS == static_cast<size_t>(EquipmentSlot::NONE), "TOTAL_NUMBER_OF_SLOTS counts every slot before NONE");
+
+inline std::string_view statTypeToString(StatType type) { return STAT_TYPE_NAMES.name(type); }
+
+inline StatType stringToStatType(std::string_view s) { // Throws std::runtime_error for an unknown name
+	StatType type;
+	if (!STAT_TYPE_NAMES.parse(s, type)) throw std::runtime_error("Unknown StatType string: " + std::string(s));
+	return type;
+}
+
+inline EquipmentSlot stringToEquipmentSlot(std::string_view s) { // NONE for an unknown name
+	EquipmentSlot slot = EquipmentSlot::NONE;
+	EQUIPMENT_SLOT_NAMES.parse(s, slot);
+	return slot;
+}
+
+inline std::string_view equipmentSlotToString(EquipmentSlot s) { return EQUIPMENT_SLOT_NAMES.name(s, "NONE"); }
+
 
 #endif // STATS_H
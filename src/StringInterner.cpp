@@ -0,0 +1,21 @@
+#include "StringInterner.h"
+
+std::string_view StringInterner::intern(std::string_view text) {
+	std::lock_guard<std::mutex> lock(mutex);
+	auto it = index.find(text);
+	if (it != index.end()) return *it;
+	const std::string& stored = storage.emplace_back(text);
+	std::string_view view(stored);
+	index.insert(view);
+	return view;
+}
+
+size_t StringInterner::size() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return index.size();
+}
+
+StringInterner& StringInterner::names() {
+	static StringInterner interner;
+	return interner;
+}
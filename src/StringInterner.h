@@ -0,0 +1,39 @@
+#ifndef STRINGINTERNER_H
+#define STRINGINTERNER_H
+
+#include <string>
+#include <string_view>
+#include <deque>
+#include <unordered_set>
+#include <mutex>
+
+/* String interning for display names
+	Item, boss and enemy names are copied onto items and mechs all the time, but there are only so
+	many different ones. intern() keeps one copy of each and hands out views into it, so a name is a
+	std::string_view that can be copied, stored and compared without allocating.
+
+	Interned strings are never freed: a view stays valid for the rest of the process, across data
+	reloads. The set grows by one entry per distinct name, i.e. per edit to data/ and per floor
+	reached (grunt and generated boss names carry the floor number), a few bytes each.
+
+	Safe to call from any thread.
+*/
+class StringInterner {
+public:
+	std::string_view intern(std::string_view text);
+	size_t size() const;
+
+	static StringInterner& names(); // The process-wide table the game's names live in
+
+private:
+	mutable std::mutex mutex;
+	std::deque<std::string> storage; // A deque never moves its elements, views into them stay put
+	std::unordered_set<std::string_view> index; // Views into `storage`
+};
+
+// Shorthand for StringInterner::names().intern(text)
+inline std::string_view internName(std::string_view text) {
+	return StringInterner::names().intern(text);
+}
+
+#endif // STRINGINTERNER_H
@@ -7,8 +7,8 @@
 
 #include "Stats.h"
 
-// Generates a random doublewithin the range [min, max] (inclusive)
-inline double myRandomDouble(double min, double max) {
+// Per-thread random engine used by all game rolls
+inline std::mt19937& randomEngine() {
 	// Static ensures the random engine and distribution are initialized only once
 	//for the lifetime of the program,which is generally more efficient
 	// and provides better random sequences than re-initializing on every call.
@@ -18,37 +18,31 @@ inline double myRandomDouble(double min, double max) {
 	thread_local static std::mt19937 rng(
 		static_cast<unsigned int>(std::chrono::high_resolution_clock::now().time_since_epoch().count())
 	);
+	return rng;
+}
+
+// Reseeds the calling thread's engine, used to make a session reproducible (see Replay.h)
+inline void seedRandom(unsigned int seed) {
+	randomEngine().seed(seed);
+}
 
+// Generates a random doublewithin the range [min, max] (inclusive)
+inline double myRandomDouble(double min, double max) {
 	// if min > max, swap them to ensure correct distribution behaviour
 	if (min > max) {
 		std::swap(min, max);
 	}
 
 	std::uniform_real_distribution<double> dist(min, max);
-	return dist(rng);
+	return dist(randomEngine());
 }
 
-inline std::string rarityToString(Rarity r) {
-	switch (r) {
-		case Rarity::COMMON:
-			return std::string("COMMON");
-		case Rarity::UNCOMMON:
-			return std::string("UNCOMMON");
-		case Rarity::RARE:
-			return std::string("RARE");
-		case Rarity::LEGENDARY:
-			return std::string("LEGENDARY");
-		default:
-			return std::string("UNKNOWN");
-	}
-}
+inline std::string_view rarityToString(Rarity r) { return RARITY_NAMES.name(r); }
 
-inline Rarity stringToRarity(const std::string& s) {
-	if (s == "COMMON") return Rarity::COMMON;
-	if (s == "UNCOMMON") return Rarity::UNCOMMON;
-	if (s == "RARE") return Rarity::RARE;
-	if (s == "LEGENDARY") return Rarity::LEGENDARY;
-	throw std::runtime_error("Unknown Rarity string: " + s);
+inline Rarity stringToRarity(std::string_view s) {
+	Rarity rarity;
+	if (!RARITY_NAMES.parse(s, rarity)) throw std::runtime_error("Unknown Rarity string: " + std::string(s));
+	return rarity;
 }
 
 
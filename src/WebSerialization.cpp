@@ -0,0 +1,76 @@
+#include "WebSerialization.h"
+
+// --- JSON Serialization for GameStateForWeb ---
+// Need to tell nlohmann/json how to convert our structs to JSON
+void to_json(json& j, const Stats& s) {
+	j = json::object();
+
+	for (const auto& pair : s) {
+		j[statTypeToString(pair.first)] = pair.second;
+	}
+}
+
+// Conversion function for InventoryItemWeb so that the frontend can consume it
+void to_json(json& j, const InventoryItemWeb& item) {
+	j = json{
+		{"index", item.index},
+		{"name", item.name},
+		{"slot", item.slot},
+		{"rarity", item.rarity},
+		{"tech", item.tech}
+	};
+}
+
+// Main conversion function for GameStateForWeb
+void to_json(json& j, const GameStateForWeb& gs) {
+	json player_equip = json::object();
+	for (const auto& pair : gs.player_equipment_names) {
+		player_equip[equipmentSlotToString(pair.first)] = pair.second;
+	}
+
+	j = json {
+		{"player", {
+			{"name", gs.player_name},
+			{"hp", gs.player_hp},
+			{"max_hp", gs.player_max_hp},
+			{"shield", gs.player_shield},
+			{"max_shield", gs.player_max_shield},
+			{"level", gs.player_level},
+			{"exp", gs.player_experience},
+			{"exp_needed", gs.player_next_level_experience},
+			{"stats", gs.player_total_stats}, // Uses the Stats to_json helper
+			{"equipment", player_equip}
+
+		}},
+		{"enemy", {
+			{"name", gs.enemy_name},
+			{"hp", gs.enemy_hp},
+			{"max_hp", gs.enemy_max_hp},
+			{"shield", gs.enemy_shield},
+			{"max_shield", gs.enemy_max_shield},
+			{"is_boss", gs.enemy_is_boss},
+			{"stats", gs.enemy_stats}
+		}},
+		{"progress", {
+			{"floor", gs.current_floor},
+			{"enemies_defeated", gs.enemies_defeated_on_floor}
+		}},
+		{"log", gs.recent_log}
+	};
+}
+
+// Helper to convert Stats map to JSON object
+void mech_stats_to_json(json& j, Mech& m) {
+	j = json::object();
+	json wrapped_json_object;
+	Stats s = m.getBaseStats();
+	std::string mech_name_key(m.getName());
+
+	for (const auto& pair : s) {
+		wrapped_json_object[statTypeToString(pair.first)] = pair.second;
+	}
+
+	j[mech_name_key] = wrapped_json_object;
+}
+
+// --- End JSON Serialization ---
@@ -0,0 +1,20 @@
+#ifndef WEBSERIALIZATION_H
+#define WEBSERIALIZATION_H
+
+#include <string>
+
+#include "Game.h"
+#include "json.hpp"
+
+using json = nlohmann::json;
+
+// --- JSON Serialization for GameStateForWeb ---
+// Need to tell nlohmann/json how to convert our structs to JSON
+void to_json(json& j, const Stats& s);
+void to_json(json& j, const InventoryItemWeb& item);
+void to_json(json& j, const GameStateForWeb& gs);
+
+// Helper to convert Stats map to JSON object
+void mech_stats_to_json(json& j, Mech& m);
+
+#endif // WEBSERIALIZATION_H
@@ -2,192 +2,283 @@
 #include <string>
 #include <vector>
 #include <fstream>
+#include <filesystem>
+#include <future>
 #include "crow_all.h"
 #include "Game.h"
+#include "WebSerialization.h"
+#include "AssetCache.h"
+#include "PageCache.h"
+#include "ResponseCache.h"
+#include "DataWatcher.h"
+#include "EmbeddedAssets.h"
 #include "json.hpp"
 
 using json = nlohmann::json;
 
 
-// Helper to convert EquipmentSlot enum to string
-std::string slotToString(EquipmentSlot slot) {
-	switch(slot) {
-		case EquipmentSlot::HEAD: return "HEAD";
-		case EquipmentSlot::CHEST: return "CHEST";
-		case EquipmentSlot::ARMS: return "ARMS";
-		case EquipmentSlot::LEGS: return "LEGS";
-		case EquipmentSlot::GENERATOR: return "GENERATOR";
-		case EquipmentSlot::LEFT_ARM_WEAPON: return "LEFT_ARM_WEAPON";
-		case EquipmentSlot::RIGHT_ARM_WEAPON: return "RIGHT_ARM_WEAPON";
-		case EquipmentSlot::LEFT_SHOULDER_WEAPON: return "LEFT_SHOULDER_WEAPON";
-		case EquipmentSlot::RIGHT_SHOULDER_WEAPON: return "RIGHT_SHOULDER_WEAPON";
-		default: return "NONE";
+// Swallows output, used to keep replays from spending their time in logging
+class NullBuffer : public std::streambuf {
+protected:
+	int overflow(int c) override { return c; }
+};
+
+#define IMMUTABLE_CACHE_CONTROL "public, max-age=31536000, immutable" // For `?v=<hash>` asset URLs
+#define REVALIDATE_CACHE_CONTROL "no-cache" // Plain asset URLs, browsers revalidate with the ETag
+
+// Public URL of a cached asset, or an empty string if no route serves it
+std::string assetPublicUrl(const std::string& path) {
+	if (path == "script.js" || path == "style.css") return "/" + path;
+	if (path.compare(0, 6, "media/") == 0) return "/web/" + path;
+	return "";
+}
+
+// Mustache context exposing every routed asset as `<path>_url` with non-alphanumerics replaced,
+// e.g. {{{script_js_url}}} -> /script.js?v=<hash>
+crow::mustache::context makeAssetUrlContext(const AssetCache& asset_cache) {
+	crow::mustache::context ctx;
+	for (const auto& pair : asset_cache.getAssets()) {
+		std::string url = assetPublicUrl(pair.first);
+		if (url.empty()) continue;
+
+		std::string key = pair.first;
+		for (char& c : key) {
+			if (!std::isalnum(static_cast<unsigned char>(c))) c = '_';
+		}
+		ctx[key + "_url"] = url + "?v=" + pair.second.hash;
 	}
+	return ctx;
 }
 
-// --- JSON Serialization for GameStateForWeb ---
-// Need to tell nlohmann/json how to convert our structs to JSON
-void to_json(json& j, const Stats& s) {
-	j = json::object();
-
-	for (const auto& pair : s) {
-		// Convert StatType enum to string for JSON key
-		std::string key;
-		switch(pair.first) {
-			case StatType::HEALTH:
-				key = "HEALTH";
-				break;
-			case StatType::ARMOR:
-				key = "ARMOR";
-				break;
-			case StatType::ENERGY_SHIELD:
-				key = "ENERGY_SHIELD";
-				break;
-			case StatType::ATTACK:
-				key = "ATTACK";
-				break;
-			case StatType::ATTACK_SPEED:
-				key = "ATTACK_SPEED";
-				break;
-			case StatType::MOBILITY:
-				key = "MOBILITY";
-				break;
-			case StatType::ENERGY:
-				key = "ENERGY";
-				break;
-			case StatType::ENERGY_RECOVERY:
-				key = "ENERGY_RECOVERY";
-				break;
-			case StatType::REPAIR:
-				key = "REPAIR";
-				break;
-			case StatType::TECHNOLOGY:
-				key = "TECHNOLOGY";
-				break;
-			default:
-				key = "UNKNOWN";
-				break;
+// Writes a cached asset into `res`, choosing the encoding from the request's Accept-Encoding.
+// Answers with 304 when the client's validators still match.
+void serveCachedAsset(const crow::request& req, crow::response& res, const CachedAsset& asset) {
+	const char* version = req.url_params.get("v");
+	bool versioned_url = version && asset.hash == version;
+
+	res.set_header("ETag", asset.etag);
+	res.set_header("Last-Modified", asset.last_modified);
+	res.set_header("Cache-Control", versioned_url ? IMMUTABLE_CACHE_CONTROL : REVALIDATE_CACHE_CONTROL);
+	if (AssetCache::isCompressible(asset.content_type)) {
+		res.set_header("Vary", "Accept-Encoding");
+	}
+
+	if (AssetCache::isNotModified(asset, req.get_header_value("If-None-Match"), req.get_header_value("If-Modified-Since"))) {
+		res.code = 304;
+		return;
+	}
+
+	res.set_header("Accept-Ranges", "bytes");
+	res.set_header("Content-Type", asset.content_type);
+
+	// Ranges always refer to the identity bytes, so a partial response is never encoded
+	const std::string& range = req.get_header_value("Range");
+	if (!range.empty() && AssetCache::isRangeValid(asset, req.get_header_value("If-Range"))) {
+		size_t first = 0;
+		size_t last = 0;
+		RangeResult result = AssetCache::parseRange(range, asset.identity.size(), first, last);
+		if (result == RangeResult::UNSATISFIABLE) {
+			res.code = 416;
+			res.set_header("Content-Range", "bytes */" + std::to_string(asset.identity.size()));
+			return;
 		}
+		if (result == RangeResult::PARTIAL) {
+			res.code = 206;
+			res.set_header("Content-Range", "bytes " + std::to_string(first) + "-" + std::to_string(last) + "/" + std::to_string(asset.identity.size()));
+			std::string_view part = asset.identity.substr(first, last - first + 1);
+			res.body.assign(part.data(), part.size());
+			return;
+		}
+	}
 
-		j[key] = pair.second;
+	ContentEncoding encoding;
+	std::string_view body = AssetCache::selectVariant(asset, req.get_header_value("Accept-Encoding"), encoding);
+
+	if (encoding != ContentEncoding::IDENTITY) {
+		res.set_header("Content-Encoding", contentEncodingToString(encoding));
 	}
+	res.body.assign(body.data(), body.size()); // crow responses own their body, this is the only copy
 }
 
-// Conversion function for InventoryItemWeb so that the frontend can consume it
-void to_json(json& j, const InventoryItemWeb& item) {
-	j = json{
-		{"index", item.index},
-		{"name", item.name},
-		{"slot", item.slot},
-		{"rarity", item.rarity},
-		{"tech", item.tech}
-	};
-}
+// Loads the compiled pack (see DataPack.h) unless it is missing or a JSON file was edited after it was built.
+// A binary with embedded assets only ever loads the pack compiled into it, whatever is on disk.
+void loadGameData(Game& game_instance) {
+	if (hasEmbeddedAssets()) {
+		std::string_view embedded_pack;
+		if (!findEmbeddedAsset(DATA_PACK_DEFAULT_PATH, embedded_pack)) {
+			throw std::runtime_error(DATA_PACK_DEFAULT_PATH " is not embedded in this binary");
+		}
+		game_instance.loadDataPack(DataPack::openBytes(embedded_pack, nullptr)); // Read-only memory that lives as long as the program
+		return;
+	}
+
+	const std::string json_files[] = {"data/items.json", "data/bosses.json", "data/levels.json", "data/loot.json", "data/classes.json"};
 
-// Main conversion function for GameStateForWeb
-void to_json(json& j, const GameStateForWeb& gs) {
-	json player_equip = json::object();
-	for (const auto& pair : gs.player_equipment_names) {
-		player_equip[slotToString(pair.first)] = pair.second;
+	std::error_code error;
+	auto pack_time = std::filesystem::last_write_time(DATA_PACK_DEFAULT_PATH, error);
+	bool use_pack = !error;
+	for (const std::string& file : json_files) {
+		auto json_time = std::filesystem::last_write_time(file, error);
+		if (use_pack && !error && json_time > pack_time) {
+			std::cout << file << " is newer than " << DATA_PACK_DEFAULT_PATH << ", loading the JSON instead." << std::endl;
+			use_pack = false;
+		}
 	}
 
-	j = json {
-		{"player", {
-			{"name", gs.player_name},
-			{"hp", gs.player_hp},
-			{"max_hp", gs.player_max_hp},
-			{"shield", gs.player_shield},
-			{"max_shield", gs.player_max_shield},
-			{"level", gs.player_level},
-			{"exp", gs.player_experience},
-			{"exp_needed", gs.player_next_level_experience},
-			{"stats", gs.player_total_stats}, // Uses the Stats to_json helper
-			{"equipment", player_equip}
-
-		}},
-		{"enemy", {
-			{"name", gs.enemy_name},
-			{"hp", gs.enemy_hp},
-			{"max_hp", gs.enemy_max_hp},
-			{"shield", gs.enemy_shield},
-			{"max_shield", gs.enemy_max_shield},
-			{"is_boss", gs.enemy_is_boss},
-			{"stats", gs.enemy_stats}
-		}},
-		{"progress", {
-			{"floor", gs.current_floor},
-			{"enemies_defeated", gs.enemies_defeated_on_floor}
-		}},
-		{"log", gs.recent_log}
-	};
+	if (use_pack) {
+		game_instance.loadDataPack(DataPack::openFile(DATA_PACK_DEFAULT_PATH));
+	} else {
+		game_instance.loadData(json_files[0], json_files[1], json_files[2], json_files[3], json_files[4]);
+	}
 }
 
-// Helper to convert Stats map to JSON object
-void mech_stats_to_json(json& j, Mech& m) {
-	j = json::object();
-	json wrapped_json_object;
-	Stats s = m.getBaseStats();
-	std::string mech_name_key = m.getName();
-
-	for (const auto& pair : s) {
-		// Convert StatType enum to string for JSON key
-		std::string key;
-		switch(pair.first) {
-			case StatType::HEALTH:
-				key = "HEALTH";
-				break;
-			case StatType::ARMOR:
-				key = "ARMOR";
-				break;
-			case StatType::ENERGY_SHIELD:
-				key = "ENERGY_SHIELD";
-				break;
-			case StatType::ATTACK:
-				key = "ATTACK";
-				break;
-			case StatType::ATTACK_SPEED:
-				key = "ATTACK_SPEED";
-				break;
-			case StatType::MOBILITY:
-				key = "MOBILITY";
-				break;
-			case StatType::ENERGY:
-				key = "ENERGY";
-				break;
-			case StatType::ENERGY_RECOVERY:
-				key = "ENERGY_RECOVERY";
-				break;
-			case StatType::REPAIR:
-				key = "REPAIR";
-				break;
-			case StatType::TECHNOLOGY:
-				key = "TECHNOLOGY";
-				break;
-			default:
-				key = "UNKNOWN";
-				break;
-		}
+// Waits for the startup load, returns false (after reporting why) if it failed
+bool waitForGameData(std::future<void>& loaded) {
+	try {
+		loaded.get();
+	} catch (const std::exception& e) {
+		std::cerr << "Error loading game data: " << e.what() << std::endl;
+		return false;
+	}
+	return true;
+}
+
+// Replays a recorded session and prints the final game state, see Replay.h
+int runReplayMode(Game& game_instance, const std::string& replay_path, uint64_t until_tick, bool verbose) {
+	ReplayLog log;
+	try {
+		log = loadReplayLog(replay_path);
+	} catch (const std::exception& e) {
+		std::cerr << "Error loading replay: " << e.what() << std::endl;
+		return 1;
+	}
 
-		wrapped_json_object[key] = pair.second;
+	NullBuffer null_buffer;
+	std::streambuf* cout_buffer = std::cout.rdbuf();
+	std::streambuf* cerr_buffer = std::cerr.rdbuf();
+	if (!verbose) {
+		std::cout.rdbuf(&null_buffer);
+		std::cerr.rdbuf(&null_buffer);
 	}
 
-	j[mech_name_key] = wrapped_json_object;
+	auto start = std::chrono::steady_clock::now();
+	game_instance.runReplay(log, until_tick);
+	double elapsed_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	json final_state = game_instance.getGameState();
+
+	std::cout.rdbuf(cout_buffer);
+	std::cerr.rdbuf(cerr_buffer);
+
+	std::cout << final_state.dump(4) << std::endl;
+	std::cout << "Replayed " << game_instance.getTickCount() << " ticks (" << (game_instance.getTickCount() * GAME_TICK_SECONDS) << "s of game time) of seed " << log.seed << " in " << elapsed_s << "s" << std::endl;
+	return 0;
 }
 
-// --- End JSON Serialization ---
+/* Command line
+	--record <file>      Record this session's seed and commands for later replay
+	--replay <file>      Replay a recorded session instead of starting the server
+	--until-tick <n>     Stop the replay after n ticks (for bisecting)
+	--verbose            Keep the game log while replaying
+	--save <file>        Resume from this save (plus its .journal) if it exists, journal progress while running and snapshot on shutdown.
+	                     Not with --record or --replay, a recording always starts from a fresh game.
+*/
+int main(int argc, char* argv[]) {
+	std::string record_path;
+	std::string replay_path;
+	uint64_t until_tick = 0;
+	bool verbose = false;
+	std::string save_path;
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg == "--record" && i + 1 < argc) {
+			record_path = argv[++i];
+		} else if (arg == "--replay" && i + 1 < argc) {
+			replay_path = argv[++i];
+		} else if (arg == "--until-tick" && i + 1 < argc) {
+			until_tick = std::stoull(argv[++i]);
+		} else if (arg == "--verbose") {
+			verbose = true;
+		} else if (arg == "--save" && i + 1 < argc) {
+			save_path = argv[++i];
+		} else {
+			std::cerr << "Unknown argument: " << arg << std::endl;
+			return 1;
+		}
+	}
+	// A recording only carries the seed and commands, replaying it always starts from a fresh game.
+	// One made on top of a restored save would diverge from its first tick.
+	if (!save_path.empty() && (!record_path.empty() || !replay_path.empty())) {
+		std::cerr << "--save can't be combined with --record or --replay: recordings start from a fresh game, not a save." << std::endl;
+		return 1;
+	}
 
-int main() {
 	// Initialize Game
 	Game game_instance;
 	
-	// Load in files from data/
+	// Load in files from data/. Nothing else at startup depends on the web assets or the other way
+	// around, so the data loads on its own thread while the assets and pages are prepared below.
+	std::future<void> game_data_loaded = std::async(std::launch::async, [&game_instance]() {
+		loadGameData(game_instance);
+	});
+
+	if (!replay_path.empty()) {
+		if (!waitForGameData(game_data_loaded)) {
+			return 1;
+		}
+		return runReplayMode(game_instance, replay_path, until_tick, verbose);
+	}
+
+	// Load every static file into memory (with precompressed variants) so requests never touch the disk
+	AssetCache asset_cache;
 	try {
-		game_instance.loadData("data/items.json", "data/bosses.json", "data/levels.json");
+		asset_cache.loadDirectory("web");
 	} catch (const std::exception& e) {
-		std::cerr << "Error loading game data: " << e.what() << std::endl;
+		std::cerr << "Error loading web assets: " << e.what() << std::endl;
+		return 1;
+	}
+
+	// Compile the pages once and render them against the hashed asset URLs, their output never changes afterwards
+	PageCache page_cache;
+	try {
+		const crow::mustache::context asset_url_ctx = makeAssetUrlContext(asset_cache);
+		for (const char* page : {"main_menu.html", "class_selection.html", "index.html"}) {
+			page_cache.compile(asset_cache, page);
+			page_cache.prerender(page, asset_url_ctx);
+		}
+	} catch (const std::exception& e) {
+		std::cerr << "Error preparing pages: " << e.what() << std::endl;
+		return 1;
+	}
+
+	// Everything below needs the data: restoring a save, the routes and the game loop
+	if (!waitForGameData(game_data_loaded)) {
 		return 1;
 	}
 
+	if (!record_path.empty() && !game_instance.enableRecording(record_path)) {
+		return 1;
+	}
+
+	if (!save_path.empty()) {
+		try {
+			if (!game_instance.enablePersistence(save_path)) {
+				return 1;
+			}
+		} catch (const std::exception& e) {
+			std::cerr << "Error loading save: " << e.what() << std::endl;
+			return 1;
+		}
+	}
+
+	// Edits to data/ go live without a restart. Recorded sessions keep the data they started with,
+	// a replay only has the files as they are when it runs, and embedded data never changes.
+	DataWatcher data_watcher;
+	if (record_path.empty() && !hasEmbeddedAssets()) {
+		data_watcher.start("data", {"items.json", "bosses.json", "levels.json", "loot.json", "classes.json", "game_data.pack"}, [&game_instance]() {
+			loadGameData(game_instance);
+		});
+	}
+
 	
 	// TODO(MSR): Move this to Game.cpp	
 	// Creating player_mech json stats file
@@ -203,12 +294,27 @@ int main() {
 	crow::SimpleApp app;
 	crow::mustache::set_global_base("web");
 
-	// API endpoint to get current game state
+	// API endpoint to get current game state, serialized and compressed at most once per game tick
+	ResponseCache gamestate_cache;
 	CROW_ROUTE(app, "/api/gamestate")
-	([&game_instance]() { // Capture game_instance by reference
-		GameStateForWeb current_state = game_instance.getGameState();
-		json response_json = current_state; // Uses the to_json function we defined
-		return crow::response(response_json.dump()); // Convert JSON object to string
+	([&game_instance, &gamestate_cache](const crow::request& req) { // Capture game_instance by reference
+		game_instance.markObserved(); // A cache hit skips getGameState, the poll still counts
+		std::shared_ptr<CachedResponse> cached = gamestate_cache.get(game_instance.getStateVersion(), [&game_instance]() {
+			GameStateForWeb current_state = game_instance.getGameState();
+			json response_json = current_state; // Uses the to_json function we defined
+			return response_json.dump(); // Convert JSON object to string
+		});
+
+		ContentEncoding encoding;
+		std::string_view body = ResponseCache::selectVariant(*cached, req.get_header_value("Accept-Encoding"), encoding);
+
+		crow::response res(std::string(body.data(), body.size()));
+		res.set_header("Content-Type", "application/json");
+		res.set_header("Vary", "Accept-Encoding");
+		if (encoding != ContentEncoding::IDENTITY) {
+			res.set_header("Content-Encoding", contentEncodingToString(encoding));
+		}
+		return res;
 	 });
 
 	// API endpoint to start the game
@@ -244,49 +350,38 @@ int main() {
 
 	// Simple route to serve the HTML file (adjust path if needed)
 	CROW_ROUTE(app, "/")
-	([]() {
-		// Might want a more robust way to find/serve files
-		// Crow has crow::mustche for templating, but simple serve is used for now
-		//auto page = crow::mustache::load("index.html");
-		auto page = crow::mustache::load("main_menu.html");
-		
-		return page.render();
+	([&page_cache](const crow::request& req) {
+		// Pre-rendered at startup, see PageCache
+		crow::response res;
+		serveCachedAsset(req, res, *page_cache.getPage("main_menu.html"));
+		return res;
 	});
 
 	// Route to serve JS
 	CROW_ROUTE(app, "/script.js")
-	([]() {
-		// Serve the file, make sure the content type is correct
-		std::ifstream t("web/script.js");
-		std::stringstream buffer;
-		buffer << t.rdbuf();
-		crow::response res(buffer.str());
-		res.set_header("Content-Type", "text/javascript");
-		return res;		
-
+	([&asset_cache](const crow::request& req) {
+		crow::response res;
+		const CachedAsset* asset = asset_cache.find("script.js");
+		if (!asset) return crow::response(404);
+		serveCachedAsset(req, res, *asset);
+		return res;
 	}); 
 
 	CROW_ROUTE(app, "/style.css")
-	([]() {
-		std::ifstream t("web/style.css");
-		std::stringstream buffer;
-		buffer << t.rdbuf();
-		crow::response res(buffer.str());
-		res.set_header("Content-Type", "text/css");
+	([&asset_cache](const crow::request& req) {
+		crow::response res;
+		const CachedAsset* asset = asset_cache.find("style.css");
+		if (!asset) return crow::response(404);
+		serveCachedAsset(req, res, *asset);
 		return res;
 	});
 
 	CROW_ROUTE(app, "/web/media/<string>")
-	([&](const crow::request& req, crow::response& res, std::string filename) {
-		std::string imagePath = "web/media/" + filename;
-		std::ifstream file(imagePath, std::ios::binary);
-
-		if (file.is_open()) {
-			std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	([&asset_cache](const crow::request& req, crow::response& res, std::string filename) {
+		const CachedAsset* asset = asset_cache.find("media/" + filename);
 
-			res.set_header("Content-Type", "image/jpeg");
-
-			res.write(content);
+		if (asset) {
+			serveCachedAsset(req, res, *asset);
 			res.end();
 		} else {
 			res.code = 404;
@@ -296,9 +391,10 @@ int main() {
 	 });
 	
 	// Serve the class Selection Screen
-	CROW_ROUTE(app, "/new_game")([](){
-		crow::mustache::context ctx;
-		return crow::mustache::load("class_selection.html").render(ctx);	
+	CROW_ROUTE(app, "/new_game")([&page_cache](const crow::request& req){
+		crow::response res;
+		serveCachedAsset(req, res, *page_cache.getPage("class_selection.html"));
+		return res;
 	});
 
 	// This will be called when the player clicks a specific class card
@@ -333,10 +429,10 @@ int main() {
 	 });
 
 	// The main game dashboard
-	CROW_ROUTE(app, "/game_dashboard")([](){
-		auto page = crow::mustache::load("index.html");
-
-		return page.render();
+	CROW_ROUTE(app, "/game_dashboard")([&page_cache](const crow::request& req){
+		crow::response res;
+		serveCachedAsset(req, res, *page_cache.getPage("index.html"));
+		return res;
 	});
 
 	// Run the server on port 18080
@@ -354,5 +450,14 @@ int main() {
 	game_instance.stopGameLoop();
 	std::cout << "Game stopped." << std::endl;
 
+	if (!save_path.empty() && game_instance.isClassSelected()) {
+		try {
+			game_instance.compactSave();
+			std::cout << "Saved to " << save_path << std::endl;
+		} catch (const std::exception& e) {
+			std::cerr << "Error saving: " << e.what() << std::endl;
+		}
+	}
+
 	return 1;
 }
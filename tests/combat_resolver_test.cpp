@@ -0,0 +1,185 @@
+#include <iostream>
+#include <string>
+#include <random>
+#include <cmath>
+#include <algorithm>
+#include <cstdlib>
+
+#include "CombatResolver.h"
+#include "Mech.h"
+
+/* CombatResolver equivalence test
+	Every fight is run twice: through resolveFight, and hit by hit through Mech::takeDamage the way
+	Game::handleCombat steps it. Both must agree on the winner, the number of exchanges and the
+	survivor's HP and shield.
+
+	Usage: combat_resolver_test [random fight count]
+	Exits non-zero if any fight disagrees.
+*/
+
+#define STEP_LIMIT 200000 // A stepped fight still going after this many exchanges is a stalemate
+#define STATE_TOLERANCE 1e-6 // Relative, the resolver multiplies where stepping subtracts repeatedly
+
+namespace {
+
+struct SteppedFight {
+	bool finished = false;
+	bool first_attacker_wins = false;
+	long long exchanges = 0;
+	double first_hp = 0, first_shield = 0;
+	double second_hp = 0, second_shield = 0;
+};
+
+Mech makeMech(const char* name, const CombatantState& state) {
+	Stats stats = {
+		{StatType::HEALTH, state.hp},
+		{StatType::ENERGY_SHIELD, state.energy_shield},
+		{StatType::ARMOR, state.armor},
+		{StatType::ATTACK, state.attack},
+	};
+	Mech mech(name, stats);
+	mech.setCombatState(state.hp, state.energy_shield);
+	return mech;
+}
+
+// Alternating turns with Mech::takeDamage, as Game::handleCombat plays a fight out
+SteppedFight stepFight(const CombatantState& first, const CombatantState& second) {
+	Mech a = makeMech("first", first);
+	Mech b = makeMech("second", second);
+
+	SteppedFight fight;
+	Mech* attacker = &a;
+	Mech* defender = &b;
+	while (fight.exchanges < STEP_LIMIT) {
+		defender->takeDamage(attacker->calculateAttackDamage());
+		fight.exchanges++;
+		if (!defender->isAlive()) {
+			fight.finished = true;
+			fight.first_attacker_wins = (defender == &b);
+			break;
+		}
+		std::swap(attacker, defender);
+	}
+	fight.first_hp = a.getCurrentHp();
+	fight.first_shield = a.getCurrentEnergyShield();
+	fight.second_hp = b.getCurrentHp();
+	fight.second_shield = b.getCurrentEnergyShield();
+	return fight;
+}
+
+bool closeEnough(double expected, double actual) {
+	return std::fabs(expected - actual) <= STATE_TOLERANCE * std::max(1.0, std::fabs(expected));
+}
+
+std::string describe(const CombatantState& s) {
+	return "{hp " + std::to_string(s.hp) + ", shield " + std::to_string(s.energy_shield) + ", armor " + std::to_string(s.armor) + ", attack " + std::to_string(s.attack) + "}";
+}
+
+int failures = 0;
+
+// Runs one fight both ways, `expect_resolvable` < 0 means either outcome is fine
+void check(const std::string& name, const CombatantState& first, const CombatantState& second, int expect_resolvable = -1) {
+	// Mech logs every hit, none of it is wanted here
+	std::cout.setstate(std::ios::failbit);
+	FightResolution resolved = resolveFight(first, second);
+	SteppedFight stepped = stepFight(first, second);
+	std::cout.clear();
+
+	std::string problem;
+	if (expect_resolvable >= 0 && resolved.resolvable != (expect_resolvable == 1)) {
+		problem = resolved.resolvable ? "resolved a stalemate" : "gave up on a winnable fight";
+	} else if (resolved.resolvable != stepped.finished) {
+		problem = resolved.resolvable ? "resolved a fight stepping never finishes" : "stepping finished a fight the resolver gave up on";
+	} else if (resolved.resolvable) {
+		if (resolved.first_attacker_wins != stepped.first_attacker_wins) {
+			problem = "winner differs";
+		} else if (resolved.exchanges != stepped.exchanges) {
+			problem = "exchanges differ: " + std::to_string(resolved.exchanges) + " resolved, " + std::to_string(stepped.exchanges) + " stepped";
+		} else if (!closeEnough(stepped.first_hp, resolved.first_attacker.hp) || !closeEnough(stepped.first_shield, resolved.first_attacker.energy_shield)) {
+			problem = "first attacker ends at hp " + std::to_string(resolved.first_attacker.hp) + " shield " + std::to_string(resolved.first_attacker.energy_shield)
+				+ ", stepping gives hp " + std::to_string(stepped.first_hp) + " shield " + std::to_string(stepped.first_shield);
+		} else if (!closeEnough(stepped.second_hp, resolved.second_attacker.hp) || !closeEnough(stepped.second_shield, resolved.second_attacker.energy_shield)) {
+			problem = "second attacker ends at hp " + std::to_string(resolved.second_attacker.hp) + " shield " + std::to_string(resolved.second_attacker.energy_shield)
+				+ ", stepping gives hp " + std::to_string(stepped.second_hp) + " shield " + std::to_string(stepped.second_shield);
+		}
+	}
+
+	if (!problem.empty()) {
+		failures++;
+		std::cerr << "FAIL " << name << ": " << problem << "\n  first  " << describe(first) << "\n  second " << describe(second) << std::endl;
+	}
+}
+
+CombatantState combatant(double hp, double energy_shield, double armor, double attack) {
+	CombatantState state;
+	state.hp = hp;
+	state.energy_shield = energy_shield;
+	state.armor = armor;
+	state.attack = attack;
+	return state;
+}
+
+void explicitCases() {
+	// Shield breaks exactly on a hit, no overflow into HP
+	check("shield breaks exactly", combatant(100, 30, 1, 5), combatant(50, 30, 1, 10), 1);
+	check("shield breaks exactly, inexact decimals", combatant(100, 0.3, 1, 0.01), combatant(1, 0.3, 1, 0.1), 1);
+	check("shield breaks exactly on the killing blow's side", combatant(40, 0, 1, 20), combatant(20, 40, 1, 1), 1);
+
+	// Armor soaks every hit to 0 once the shield is down
+	check("armor soaks the loser's hits", combatant(100, 10, 9999, 1), combatant(100, 10, 1, 10), 1);
+	check("armor above the cap soaks too", combatant(100, 0, 20000, 5), combatant(30, 0, 1, 1000), 1);
+	check("both sides soak everything", combatant(100, 5, 9999, 10), combatant(100, 5, 9999, 10), 0);
+
+	// Both mechs would die on the same exchange count: strict alternation means the first attacker lands first
+	check("same hits needed, first attacker wins", combatant(30, 0, 1, 10), combatant(30, 0, 1, 10), 1);
+	check("same hits needed, second attacker first", combatant(30, 10, 1, 10), combatant(40, 0, 1, 10), 1);
+	check("one hit each", combatant(5, 0, 1, 100), combatant(5, 0, 1, 100), 1);
+
+	// 0 attack never lands a hit
+	check("first has 0 attack", combatant(100, 0, 1, 0), combatant(100, 0, 1, 7), 1);
+	check("second has 0 attack", combatant(100, 20, 1, 7), combatant(100, 20, 1, 0), 1);
+	check("both have 0 attack", combatant(100, 0, 1, 0), combatant(100, 0, 1, 0), 0);
+
+	// Already defeated
+	check("second starts at 0 hp", combatant(10, 0, 1, 1), combatant(0, 0, 1, 1));
+}
+
+void randomCases(int count) {
+	std::mt19937 rng(20240611); // Fixed, a failure has to be reproducible
+	std::uniform_real_distribution<double> hp(1.0, 2000.0);
+	std::uniform_real_distribution<double> shield(0.0, 500.0);
+	std::uniform_real_distribution<double> armor(0.0, 9000.0); // Near the cap a single fight runs into millions of exchanges
+	std::uniform_real_distribution<double> attack(0.5, 150.0);
+	std::uniform_int_distribution<int> pick(0, 9);
+
+	for (int i = 0; i < count; i++) {
+		CombatantState sides[2];
+		for (CombatantState& side : sides) {
+			side = combatant(hp(rng), shield(rng), armor(rng), attack(rng));
+			// Mix in the shapes the game actually produces: whole numbers, no shield, no armor
+			int shape = pick(rng);
+			if (shape == 0) side = combatant(std::round(side.hp), std::round(side.energy_shield), 1, std::round(side.attack));
+			if (shape == 1) side.energy_shield = 0;
+			if (shape == 2) side.armor = 0;
+			if (shape == 3) side.energy_shield = side.attack * (1 + pick(rng)); // Breaks exactly on a hit
+			if (shape == 4 && &side == &sides[0]) side.armor = 9999 + pick(rng); // Soaks everything, the other side can only stall
+		}
+		check("random fight " + std::to_string(i), sides[0], sides[1]);
+	}
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+	int random_count = (argc > 1) ? std::max(0, std::atoi(argv[1])) : 20000;
+
+	explicitCases();
+	randomCases(random_count);
+
+	if (failures > 0) {
+		std::cerr << failures << " fight(s) disagree" << std::endl;
+		return 1;
+	}
+	std::cout << "All fights agree (" << random_count << " random + explicit cases)" << std::endl;
+	return 0;
+}
@@ -0,0 +1,63 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <cstdio>
+
+#include "DataPack.h"
+#include "MappedFile.h"
+
+/* Game-data compiler
+	Validates data/items.json, bosses.json, levels.json, loot.json and classes.json and writes the binary pack the server
+	loads at startup (see src/DataPack.h). Runs as a build step, but can be run by hand too.
+
+	Usage: idle_mech_datac <items.json> <bosses.json> <levels.json> <loot.json> <classes.json> <output.pack>
+
+	Exits non-zero with the offending file and entry if the data is invalid, so a bad edit fails
+	the build instead of the server start.
+*/
+
+static MappedFile mapSource(const std::string& path) {
+	MappedFile mapped;
+	if (!mapFile(path, mapped)) {
+		throw std::runtime_error("Failed to open " + path);
+	}
+	return mapped;
+}
+
+int main(int argc, char* argv[]) {
+	if (argc != 7) {
+		std::cerr << "Usage: " << argv[0] << " <items.json> <bosses.json> <levels.json> <loot.json> <classes.json> <output.pack>" << std::endl;
+		return 2;
+	}
+
+	try {
+		MappedFile sources[] = {mapSource(argv[1]), mapSource(argv[2]), mapSource(argv[3]), mapSource(argv[4]), mapSource(argv[5])};
+		std::vector<DataSourceTiming> timings;
+		std::string pack = compileDataPack(sources[0].contents, sources[1].contents, sources[2].contents, sources[3].contents, sources[4].contents, &timings);
+		DataPack::openBytes(pack, nullptr); // Round-trip check, never ship a pack the server would refuse
+		// A running server keeps the pack it loaded mapped (bosses are read from it lazily), so the
+		// old file is replaced by a rename instead of being overwritten in place
+		std::string output = argv[6];
+		std::string temp_output = output + ".tmp";
+		{
+			std::ofstream out(temp_output, std::ios::binary | std::ios::trunc);
+			if (!out.write(pack.data(), pack.size()) || !out.flush()) {
+				throw std::runtime_error("Failed to write " + temp_output);
+			}
+		}
+		if (std::rename(temp_output.c_str(), output.c_str()) != 0) {
+			std::remove(temp_output.c_str());
+			throw std::runtime_error("Failed to replace " + output);
+		}
+		for (const DataSourceTiming& timing : timings) {
+			std::cout << "Parsed " << timing.file << " (" << timing.bytes << " bytes) in " << timing.milliseconds << " ms" << std::endl;
+		}
+		std::cout << "Wrote " << argv[6] << " (" << pack.size() << " bytes)" << std::endl;
+	} catch (const std::exception& e) {
+		std::cerr << "idle_mech_datac: " << e.what() << std::endl;
+		return 1;
+	}
+	return 0;
+}
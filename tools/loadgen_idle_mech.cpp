@@ -0,0 +1,225 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <map>
+#include <cstring>
+#include <cstdlib>
+
+#include <unistd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+/* Local HTTP load generator for the idle_mech_rpg web API
+	Opens N keep-alive connections to a server on 127.0.0.1 and replays a mix of
+	GET /api/gamestate polls and POST /api/equip requests as fast as the server answers.
+
+	Usage: loadgen_idle_mech [--port 18080] [--connections 16] [--duration 10] [--equip-percent 5]
+
+	Reports requests/sec, p50/p99/p999/max latency and the status code histogram.
+	Only ever connects to localhost.
+*/
+
+struct LoadgenConfig {
+	int port = 18080;
+	int connections = 16;
+	int duration_s = 10;
+	int equip_percent = 5; // Share of requests that are equips, the rest are polls
+};
+
+struct ConnectionStats {
+	std::vector<long long> latencies_ns;
+	std::map<int, long long> status_counts;
+	long long errors = 0;
+	long long reconnects = 0;
+};
+
+// Opens a TCP connection to the local server, returns -1 on failure
+int connectLocal(int port) {
+	int fd = socket(AF_INET, SOCK_STREAM, 0);
+	if (fd < 0) return -1;
+
+	int one = 1;
+	setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+	sockaddr_in addr{};
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons(static_cast<uint16_t>(port));
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+		close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+bool sendAll(int fd, const std::string& data) {
+	size_t sent = 0;
+	while (sent < data.size()) {
+		ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+		if (n <= 0) return false;
+		sent += static_cast<size_t>(n);
+	}
+	return true;
+}
+
+// Reads one HTTP response (Content-Length framed). Returns the status code, or -1 on error.
+// `buffer` keeps any bytes read past the end of this response. `keep_alive` is cleared on "Connection: close".
+int readResponse(int fd, std::string& buffer, bool& keep_alive) {
+	char chunk[16384];
+	size_t header_end;
+	while ((header_end = buffer.find("\r\n\r\n")) == std::string::npos) {
+		ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+		if (n <= 0) return -1;
+		buffer.append(chunk, static_cast<size_t>(n));
+	}
+
+	std::string headers = buffer.substr(0, header_end);
+	int status = -1;
+	if (headers.size() > 12 && headers.compare(0, 5, "HTTP/") == 0) {
+		status = std::atoi(headers.c_str() + headers.find(' ') + 1);
+	}
+
+	std::string lower_headers = headers;
+	std::transform(lower_headers.begin(), lower_headers.end(), lower_headers.begin(), ::tolower);
+	size_t content_length = 0;
+	size_t cl_pos = lower_headers.find("content-length:");
+	if (cl_pos != std::string::npos) {
+		content_length = std::strtoul(lower_headers.c_str() + cl_pos + 15, nullptr, 10);
+	}
+	keep_alive = lower_headers.find("connection: close") == std::string::npos;
+
+	size_t total = header_end + 4 + content_length;
+	while (buffer.size() < total) {
+		ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+		if (n <= 0) return -1;
+		buffer.append(chunk, static_cast<size_t>(n));
+	}
+	buffer.erase(0, total);
+	return status;
+}
+
+void runConnection(const LoadgenConfig& config, std::chrono::steady_clock::time_point deadline, unsigned int seed, ConnectionStats& stats) {
+	std::mt19937 rng(seed);
+	std::uniform_int_distribution<int> percent(0, 99);
+	std::uniform_int_distribution<int> inventory_index(0, 9);
+
+	const std::string poll_request =
+		"GET /api/gamestate HTTP/1.1\r\n"
+		"Host: localhost\r\n"
+		"Connection: keep-alive\r\n\r\n";
+
+	int fd = connectLocal(config.port);
+	std::string buffer;
+	while (std::chrono::steady_clock::now() < deadline) {
+		if (fd < 0) {
+			stats.errors++;
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+			fd = connectLocal(config.port);
+			stats.reconnects++;
+			continue;
+		}
+
+		std::string request;
+		if (percent(rng) < config.equip_percent) {
+			std::string body = "{\"index\": " + std::to_string(inventory_index(rng)) + "}";
+			request = "POST /api/equip HTTP/1.1\r\n"
+				"Host: localhost\r\n"
+				"Connection: keep-alive\r\n"
+				"Content-Type: application/json\r\n"
+				"Content-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body;
+		} else {
+			request = poll_request;
+		}
+
+		auto start = std::chrono::steady_clock::now();
+		bool keep_alive = true;
+		int status = sendAll(fd, request) ? readResponse(fd, buffer, keep_alive) : -1;
+		auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+		if (status < 0) {
+			stats.errors++;
+			close(fd);
+			fd = -1;
+			buffer.clear();
+			continue;
+		}
+		stats.latencies_ns.push_back(elapsed);
+		stats.status_counts[status]++;
+
+		if (!keep_alive) {
+			close(fd);
+			fd = connectLocal(config.port);
+			buffer.clear();
+			stats.reconnects++;
+		}
+	}
+	if (fd >= 0) close(fd);
+}
+
+double percentileMs(const std::vector<long long>& sorted_ns, double p) {
+	if (sorted_ns.empty()) return 0.0;
+	size_t idx = static_cast<size_t>(p * (sorted_ns.size() - 1));
+	return sorted_ns[idx] / 1e6;
+}
+
+int main(int argc, char* argv[]) {
+	LoadgenConfig config;
+	for (int i = 1; i + 1 < argc; i += 2) {
+		std::string arg = argv[i];
+		int value = std::atoi(argv[i + 1]);
+		if (arg == "--port") config.port = value;
+		else if (arg == "--connections") config.connections = std::max(1, value);
+		else if (arg == "--duration") config.duration_s = std::max(1, value);
+		else if (arg == "--equip-percent") config.equip_percent = std::max(0, std::min(100, value));
+		else {
+			std::cerr << "Unknown option: " << arg << std::endl;
+			return 1;
+		}
+	}
+
+	std::cout << "Load testing http://127.0.0.1:" << config.port << " with " << config.connections
+		<< " connections for " << config.duration_s << "s (" << config.equip_percent << "% equips)" << std::endl;
+
+	std::vector<ConnectionStats> stats(config.connections);
+	std::vector<std::thread> threads;
+	auto start = std::chrono::steady_clock::now();
+	auto deadline = start + std::chrono::seconds(config.duration_s);
+	for (int i = 0; i < config.connections; i++) {
+		threads.emplace_back(runConnection, std::cref(config), deadline, static_cast<unsigned int>(i + 1), std::ref(stats[i]));
+	}
+	for (auto& t : threads) t.join();
+	double elapsed_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	// Merge per-connection results
+	std::vector<long long> latencies;
+	std::map<int, long long> status_counts;
+	long long errors = 0, reconnects = 0;
+	for (const auto& s : stats) {
+		latencies.insert(latencies.end(), s.latencies_ns.begin(), s.latencies_ns.end());
+		for (const auto& pair : s.status_counts) status_counts[pair.first] += pair.second;
+		errors += s.errors;
+		reconnects += s.reconnects;
+	}
+	std::sort(latencies.begin(), latencies.end());
+
+	std::cout << "\n--- Results ---" << std::endl;
+	std::cout << "Requests: " << latencies.size() << " in " << elapsed_s << "s" << std::endl;
+	std::cout << "Requests/sec: " << (latencies.size() / elapsed_s) << std::endl;
+	std::cout << "Latency p50: " << percentileMs(latencies, 0.50) << " ms" << std::endl;
+	std::cout << "Latency p99: " << percentileMs(latencies, 0.99) << " ms" << std::endl;
+	std::cout << "Latency p999: " << percentileMs(latencies, 0.999) << " ms" << std::endl;
+	std::cout << "Latency max: " << (latencies.empty() ? 0.0 : latencies.back() / 1e6) << " ms" << std::endl;
+	std::cout << "Errors: " << errors << ", reconnects: " << reconnects << std::endl;
+	for (const auto& pair : status_counts) {
+		std::cout << "HTTP " << pair.first << ": " << pair.second << std::endl;
+	}
+	std::cout << "---" << std::endl;
+	return 0;
+}